@@ -0,0 +1,60 @@
+/**
+ * @file AllocationHooks.cpp
+ * @brief 带计数的全局operator new/delete
+ * @details 只链接进需要报告堆分配的程序（游戏、dino_bench、dino_server），
+ *          训练器、差分对照等多线程工具使用标准库的分配函数，不承担计数的原子操作
+ */
+
+#include "MemoryTracking.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+void* countedAllocate(std::size_t size) {
+    countHeapAllocation(size);
+    if (size == 0) size = 1;
+    for (;;) {
+        void* p = std::malloc(size);
+        if (p) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+/**
+ * @brief 超对齐分配：多申请alignment加一个指针的空间，对齐地址前一格保存malloc返回的原始地址
+ * @details std::pmr::new_delete_resource等经由对齐版本的operator new分配，同样需要计数
+ */
+void* countedAlignedAllocate(std::size_t size, std::align_val_t alignment) {
+    std::size_t align = std::max((std::size_t)alignment, sizeof(void*));
+    void* raw = countedAllocate(size + align + sizeof(void*));
+    std::uintptr_t aligned = ((std::uintptr_t)raw + sizeof(void*) + align - 1) & ~(std::uintptr_t)(align - 1);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void alignedFree(void* p) {
+    if (p) {
+        std::free(reinterpret_cast<void**>(p)[-1]);
+    }
+}
+
+}  // namespace
+
+// 替换全局分配函数：标准库的nothrow版本经由对应的抛出版本分配
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAlignedAllocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAlignedAllocate(size, alignment); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
@@ -0,0 +1,128 @@
+/**
+ * @file AnalyzerMain.cpp
+ * @brief 赛道可解性分析器主程序
+ * @details 分析一组连续种子（按线程并行）或一份录制的生成记录，逐条输出结果和汇总
+ *
+ * 用法：dino_analyzer [--seed N] [--count N] [--frames N] [--threads N]
+ *                     [--spawns 文件] [--export 文件]
+ */
+
+#include "CourseAnalyzer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void printResult(const char* label, uint64_t seed, const AnalysisResult& result) {
+    std::cout << label << ' ' << seed << ": ";
+    if (result.survivable) {
+        std::cout << "survivable to frame " << result.frames;
+    } else {
+        std::cout << "unavoidable death at frame " << result.deathFrame << " (score " << result.deathFrame + 1 << ")";
+    }
+    std::cout << ", peak states " << result.peakStates << '\n';
+}
+
+}  // namespace
+
+/**
+ * @brief 分析器主入口
+ * @return 参数错误或文件读写失败返回1，否则返回0
+ */
+int main(int argc, char** argv) {
+    uint64_t firstSeed = 1;
+    int count = 1;
+    int frames = 1000000;
+    int threads = 0;
+    std::string spawnsPath;
+    std::string exportPath;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::cerr << "missing value for " << arg << std::endl;
+            return 1;
+        }
+        if (std::strcmp(arg, "--seed") == 0) {
+            firstSeed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--count") == 0) {
+            count = std::atoi(value);
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            frames = std::atoi(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--spawns") == 0) {
+            spawnsPath = value;
+        } else if (std::strcmp(arg, "--export") == 0) {
+            exportPath = value;
+        } else {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return 1;
+        }
+        i++;
+    }
+    if (frames <= 0 || count <= 0) {
+        std::cerr << "--frames and --count must be positive" << std::endl;
+        return 1;
+    }
+
+    // 导出种子对应的生成记录，供录制格式的分析和外部工具使用
+    if (!exportPath.empty()) {
+        ObstacleSchedule schedule(firstSeed);
+        if (!saveSpawns(exportPath, schedule.spawnsBetween(0, frames - 1))) {
+            std::cerr << "cannot write " << exportPath << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!spawnsPath.empty()) {
+        std::vector<ScheduledSpawn> spawns;
+        if (!loadSpawns(spawnsPath, spawns)) {
+            std::cerr << "cannot read " << spawnsPath << std::endl;
+            return 1;
+        }
+        CourseAnalyzer analyzer;
+        printResult("recording", 0, analyzer.analyzeSpawns(spawns, frames));
+    } else {
+        // 每个线程有自己的分析器（后继缓存在线程内的种子之间共享），按原子计数器领取种子
+        int threadCount = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+        threadCount = std::max(1, std::min(threadCount, count));
+        std::vector<AnalysisResult> results(count);
+        std::atomic<int> nextIndex(0);
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threadCount; t++) {
+            workers.emplace_back([&]() {
+                CourseAnalyzer analyzer;
+                for (int index = nextIndex++; index < count; index = nextIndex++) {
+                    results[index] = analyzer.analyzeSeed(firstSeed + index, frames);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        int doomed = 0;
+        for (int index = 0; index < count; index++) {
+            printResult("seed", firstSeed + index, results[index]);
+            doomed += !results[index].survivable;
+        }
+        std::cout << doomed << " of " << count << " courses unwinnable within " << frames << " frames\n";
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "analyzed in " << seconds << " s" << std::endl;
+    return 0;
+}
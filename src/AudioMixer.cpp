@@ -0,0 +1,462 @@
+/**
+ * @file AudioMixer.cpp
+ * @brief 音效混音器实现文件
+ * @details 无锁事件环、混音线程、音效合成和各种输出端
+ */
+
+#include "AudioMixer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+static_assert((AudioEventQueue::CAPACITY & (AudioEventQueue::CAPACITY - 1)) == 0,
+              "audio event capacity must be a power of two");
+
+namespace {
+
+uint64_t audioNowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 追加一段方波，频率从startHz线性滑到endHz，结尾5毫秒线性淡出以免爆音
+ */
+void appendTone(std::vector<int16_t>& pcm, int sampleRate, double startHz, double endHz, int ms, int amplitude) {
+    const int count = sampleRate * ms / 1000;
+    const int fade = std::min(count, sampleRate * 5 / 1000);
+    double phase = 0;
+    for (int i = 0; i < count; i++) {
+        double hz = startHz + (endHz - startHz) * i / count;
+        phase += hz / sampleRate;
+        phase -= std::floor(phase);
+        double gain = (i >= count - fade) ? (double)(count - i) / fade : 1.0;
+        pcm.push_back((int16_t)((phase < 0.5 ? amplitude : -amplitude) * gain));
+    }
+}
+
+void appendSilence(std::vector<int16_t>& pcm, int sampleRate, int ms) {
+    pcm.insert(pcm.end(), (size_t)(sampleRate * ms / 1000), 0);
+}
+
+void putLittleEndian(FILE* file, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        std::fputc((int)((value >> (8 * i)) & 0xFF), file);
+    }
+}
+
+uint32_t getLittleEndian(const unsigned char* p, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint32_t)p[i] << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief 写出WAV头（16位单声道PCM）
+ */
+void writeWavHeader(FILE* file, int sampleRate, uint32_t dataBytes) {
+    std::fwrite("RIFF", 1, 4, file);
+    putLittleEndian(file, 36 + dataBytes, 4);
+    std::fwrite("WAVEfmt ", 1, 8, file);
+    putLittleEndian(file, 16, 4);               // fmt块长度
+    putLittleEndian(file, 1, 2);                // PCM
+    putLittleEndian(file, 1, 2);                // 单声道
+    putLittleEndian(file, (uint32_t)sampleRate, 4);
+    putLittleEndian(file, (uint32_t)sampleRate * 2, 4);
+    putLittleEndian(file, 2, 2);                // 每帧字节数
+    putLittleEndian(file, 16, 2);               // 位深
+    std::fwrite("data", 1, 4, file);
+    putLittleEndian(file, dataBytes, 4);
+}
+
+}  // namespace
+
+// ==================== AudioEventQueue类实现 ====================
+
+bool AudioEventQueue::push(const AudioEvent& event) {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= CAPACITY) {
+        return false;
+    }
+    slots[h & (CAPACITY - 1)] = event;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool AudioEventQueue::pop(AudioEvent& event) {
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    event = slots[t & (CAPACITY - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+// ==================== 输出端实现 ====================
+
+bool NullAudioSink::begin(int, int) {
+    samples = 0;
+    audibleBuffers = 0;
+    return true;
+}
+
+bool NullAudioSink::write(const int16_t* data, size_t count) {
+    samples += (long long)count;
+    audibleBuffers += std::any_of(data, data + count, [](int16_t s) { return s != 0; });
+    return true;
+}
+
+WavFileAudioSink::~WavFileAudioSink() {
+    end();
+}
+
+bool WavFileAudioSink::begin(int rate, int) {
+    end();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    sampleRate = rate;
+    dataBytes = 0;
+    writeWavHeader(file, sampleRate, 0);        // 长度在end时补写
+    return true;
+}
+
+bool WavFileAudioSink::write(const int16_t* samples, size_t count) {
+    if (!file) return false;
+    for (size_t i = 0; i < count; i++) {
+        putLittleEndian(file, (uint16_t)samples[i], 2);
+    }
+    dataBytes += (uint32_t)(count * 2);
+    return !std::ferror(file);
+}
+
+void WavFileAudioSink::end() {
+    if (!file) return;
+    std::fseek(file, 0, SEEK_SET);
+    writeWavHeader(file, sampleRate, dataBytes);
+    std::fclose(file);
+    file = nullptr;
+}
+
+#ifdef _WIN32
+WaveOutAudioSink::~WaveOutAudioSink() {
+    end();
+}
+
+bool WaveOutAudioSink::begin(int sampleRate, int bufferFrames) {
+    end();
+    WAVEFORMATEX format = {};
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = 1;
+    format.nSamplesPerSec = (DWORD)sampleRate;
+    format.nAvgBytesPerSec = (DWORD)sampleRate * 2;
+    format.nBlockAlign = 2;
+    format.wBitsPerSample = 16;
+    HWAVEOUT handle = nullptr;
+    if (waveOutOpen(&handle, WAVE_MAPPER, &format, 0, 0, CALLBACK_NULL) != MMSYSERR_NOERROR) {
+        return false;
+    }
+    device = handle;
+    for (std::vector<int16_t>& buffer : buffers) {
+        buffer.assign((size_t)bufferFrames, 0);
+    }
+    headers.assign(sizeof(WAVEHDR) * QUEUED_BUFFERS, 0);
+    next = 0;
+    return true;
+}
+
+/**
+ * @details 设备队列中保持QUEUED_BUFFERS个缓冲区；复用一个缓冲区之前等它播放完毕，
+ *          混音线程因此按播放进度运行
+ */
+bool WaveOutAudioSink::write(const int16_t* samples, size_t count) {
+    if (!device) return false;
+    HWAVEOUT handle = (HWAVEOUT)device;
+    WAVEHDR* header = reinterpret_cast<WAVEHDR*>(&headers[sizeof(WAVEHDR) * next]);
+    if (header->dwFlags & WHDR_PREPARED) {
+        while (!(*static_cast<volatile DWORD*>(&header->dwFlags) & WHDR_DONE)) {
+            Sleep(1);
+        }
+        waveOutUnprepareHeader(handle, header, sizeof(WAVEHDR));
+    }
+    std::vector<int16_t>& buffer = buffers[next];
+    count = std::min(count, buffer.size());
+    std::copy(samples, samples + count, buffer.begin());
+    std::memset(header, 0, sizeof(WAVEHDR));
+    header->lpData = reinterpret_cast<LPSTR>(buffer.data());
+    header->dwBufferLength = (DWORD)(count * 2);
+    if (waveOutPrepareHeader(handle, header, sizeof(WAVEHDR)) != MMSYSERR_NOERROR ||
+        waveOutWrite(handle, header, sizeof(WAVEHDR)) != MMSYSERR_NOERROR) {
+        return false;
+    }
+    next = (next + 1) % QUEUED_BUFFERS;
+    return true;
+}
+
+void WaveOutAudioSink::end() {
+    if (!device) return;
+    HWAVEOUT handle = (HWAVEOUT)device;
+    waveOutReset(handle);
+    for (int i = 0; i < QUEUED_BUFFERS; i++) {
+        WAVEHDR* header = reinterpret_cast<WAVEHDR*>(&headers[sizeof(WAVEHDR) * i]);
+        if (header->dwFlags & WHDR_PREPARED) {
+            waveOutUnprepareHeader(handle, header, sizeof(WAVEHDR));
+        }
+    }
+    waveOutClose(handle);
+    device = nullptr;
+}
+#endif
+
+// ==================== 样本载入与合成 ====================
+
+bool loadWav(const std::string& path, std::vector<int16_t>& pcm, int& sampleRate) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 12 || std::memcmp(&bytes[0], "RIFF", 4) != 0 || std::memcmp(&bytes[8], "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool formatOk = false;
+    for (size_t pos = 12; pos + 8 <= bytes.size();) {
+        const unsigned char* chunk = &bytes[pos];
+        size_t size = getLittleEndian(chunk + 4, 4);
+        if (pos + 8 + size > bytes.size()) {
+            size = bytes.size() - pos - 8;      // 截断的文件：读取已有部分
+        }
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            formatOk = getLittleEndian(chunk + 8, 2) == 1 && getLittleEndian(chunk + 10, 2) == 1 &&
+                       getLittleEndian(chunk + 22, 2) == 16;
+            sampleRate = (int)getLittleEndian(chunk + 12, 4);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!formatOk) return false;
+            pcm.resize(size / 2);
+            for (size_t i = 0; i < pcm.size(); i++) {
+                pcm[i] = (int16_t)getLittleEndian(chunk + 8 + i * 2, 2);
+            }
+            return true;
+        }
+        pos += 8 + size + (size & 1);           // 块按偶数字节对齐
+    }
+    return false;
+}
+
+std::vector<int16_t> synthesizeCue(AudioCue cue, int sampleRate) {
+    std::vector<int16_t> pcm;
+    switch (cue) {
+    case AUDIO_JUMP:
+        appendTone(pcm, sampleRate, 660, 990, 60, 5000);
+        break;
+    case AUDIO_MILESTONE:
+        appendTone(pcm, sampleRate, 1046, 1046, 70, 4000);
+        appendSilence(pcm, sampleRate, 30);
+        appendTone(pcm, sampleRate, 1046, 1046, 70, 4000);
+        break;
+    case AUDIO_SPEED_UP:
+        appendTone(pcm, sampleRate, 784, 784, 60, 4000);
+        appendTone(pcm, sampleRate, 988, 988, 60, 4000);
+        appendTone(pcm, sampleRate, 1175, 1175, 90, 4000);
+        break;
+    case AUDIO_GAME_OVER:
+        appendTone(pcm, sampleRate, 220, 110, 250, 7000);
+        appendSilence(pcm, sampleRate, 40);
+        appendTone(pcm, sampleRate, 110, 110, 150, 7000);
+        break;
+    default:
+        break;
+    }
+    return pcm;
+}
+
+// ==================== AudioMixer类实现 ====================
+
+AudioMixer::AudioMixer(int sampleRate, int bufferFrames)
+    : sampleRate(sampleRate), bufferFrames(std::max(16, bufferFrames)), dropped(0), sink(nullptr), running(false) {}
+
+AudioMixer::~AudioMixer() {
+    stop();
+}
+
+void AudioMixer::loadDefaultClips() {
+    for (int cue = 0; cue < AUDIO_CUE_COUNT; cue++) {
+        clips[cue] = synthesizeCue((AudioCue)cue, sampleRate);
+    }
+}
+
+void AudioMixer::setClip(AudioCue cue, const std::vector<int16_t>& pcm) {
+    if (!isRunning()) {
+        clips[cue] = pcm;
+    }
+}
+
+/**
+ * @details 混音线程用到的缓冲区和延迟记录都在这里一次分配好
+ */
+bool AudioMixer::start(AudioSink* target) {
+    stop();
+    if (!target || !target->begin(sampleRate, bufferFrames)) {
+        return false;
+    }
+    sink = target;
+    for (Voice& voice : voices) {
+        voice = Voice();
+    }
+    accumulator.assign((size_t)bufferFrames, 0);
+    output.assign((size_t)bufferFrames, 0);
+    latencyUs.assign(LATENCY_CAPACITY, 0);
+    latencySamples = 0;
+    latencySumMs = 0;
+    stats = AudioStats();
+    stats.bufferMs = 1000.0 * bufferFrames / sampleRate;
+    dropped = 0;
+
+    AudioEvent stale;
+    while (queue.pop(stale)) {}                 // 上次运行遗留的事件
+    running.store(true, std::memory_order_release);
+    mixerThread = std::thread(&AudioMixer::run, this);
+    return true;
+}
+
+void AudioMixer::stop() {
+    if (!running.exchange(false)) return;
+    mixerThread.join();
+    sink->end();
+    sink = nullptr;
+}
+
+bool AudioMixer::post(AudioCue cue) {
+    if (!running.load(std::memory_order_relaxed)) return false;
+    AudioEvent event;
+    event.postedNs = audioNowNs();
+    event.cue = (uint32_t)cue;
+    if (!queue.push(event)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void AudioMixer::startVoice(const AudioEvent& event) {
+    stats.events++;
+    if (event.cue >= AUDIO_CUE_COUNT || clips[event.cue].empty()) return;
+
+    Voice* slot = nullptr;
+    for (Voice& voice : voices) {
+        if (!voice.active) {
+            slot = &voice;
+            break;
+        }
+        if (!slot || voice.position > slot->position) {
+            slot = &voice;
+        }
+    }
+    if (slot->active) {
+        stats.stolenVoices++;
+    }
+    const std::vector<int16_t>& clip = clips[event.cue];
+    slot->data = clip.data();
+    slot->length = clip.size();
+    slot->position = 0;
+    slot->postedNs = event.postedNs;
+    slot->active = true;
+    slot->started = false;
+}
+
+/**
+ * @details 以32位累加所有发声，饱和截断为16位；本缓冲区开始播放的发声在写出前记录延迟
+ */
+void AudioMixer::mixBuffer() {
+    std::fill(accumulator.begin(), accumulator.end(), 0);
+    uint64_t startedNs[MAX_VOICES];
+    int started = 0;
+
+    for (Voice& voice : voices) {
+        if (!voice.active) continue;
+        if (!voice.started) {
+            startedNs[started++] = voice.postedNs;
+            voice.started = true;
+        }
+        size_t n = std::min(accumulator.size(), voice.length - voice.position);
+        const int16_t* src = voice.data + voice.position;
+        for (size_t i = 0; i < n; i++) {
+            accumulator[i] += src[i];
+        }
+        voice.position += n;
+        voice.active = voice.position < voice.length;
+    }
+    for (size_t i = 0; i < accumulator.size(); i++) {
+        output[i] = (int16_t)std::max(-32768, std::min(32767, accumulator[i]));
+    }
+
+    uint64_t now = audioNowNs();
+    for (int i = 0; i < started; i++) {
+        uint64_t us = (now - startedNs[i]) / 1000;
+        latencyUs[(size_t)(latencySamples % LATENCY_CAPACITY)] = (uint32_t)std::min<uint64_t>(us, UINT32_MAX);
+        latencySamples++;
+        latencySumMs += us / 1000.0;
+        stats.maxLatencyMs = std::max(stats.maxLatencyMs, us / 1000.0);
+    }
+}
+
+/**
+ * @details 每个周期：取出全部事件、混音、写出。自行定时的输出端按采样时钟的截止时间休眠，
+ *          落后超过一个周期时不追赶，从当前时间重新计时并记为迟到
+ */
+void AudioMixer::run() {
+    const std::chrono::nanoseconds period((long long)bufferFrames * 1000000000LL / sampleRate);
+    auto deadline = std::chrono::steady_clock::now();
+
+    while (running.load(std::memory_order_acquire)) {
+        AudioEvent event;
+        while (queue.pop(event)) {
+            startVoice(event);
+        }
+        mixBuffer();
+        sink->write(output.data(), output.size());
+        stats.buffers++;
+
+        if (!sink->paced()) {
+            deadline += period;
+            auto now = std::chrono::steady_clock::now();
+            if (now > deadline) {
+                stats.lateBuffers++;
+                deadline = now;
+            } else {
+                std::this_thread::sleep_until(deadline);
+            }
+        }
+    }
+}
+
+AudioStats AudioMixer::getStats() const {
+    AudioStats result = stats;
+    result.dropped = dropped.load(std::memory_order_relaxed);
+    size_t kept = (size_t)std::min<long long>(latencySamples, (long long)LATENCY_CAPACITY);
+    if (kept > 0) {
+        std::vector<uint32_t> sorted(latencyUs.begin(), latencyUs.begin() + kept);
+        size_t rank = std::min(kept - 1, kept * 99 / 100);
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        result.p99LatencyMs = sorted[rank] / 1000.0;
+        result.meanLatencyMs = latencySumMs / latencySamples;
+    }
+    return result;
+}
+
+void AudioMixer::report(std::ostream& out) const {
+    AudioStats s = getStats();
+    out << "audio: " << s.events << " events, " << s.dropped << " dropped, " << s.stolenVoices << " voices stolen, "
+        << s.buffers << " buffers of " << s.bufferMs << " ms, " << s.lateBuffers << " late\n"
+        << "  event-to-buffer latency: mean " << s.meanLatencyMs << " ms, p99 " << s.p99LatencyMs << " ms, max "
+        << s.maxLatencyMs << " ms\n";
+}
@@ -0,0 +1,297 @@
+/**
+ * @file AudioMixer.h
+ * @brief 音效混音器头文件
+ * @details 游戏线程在跳跃、分数里程碑、加速和碰撞时投递音效事件，专用的混音线程把预先载入的PCM样本
+ *          混合进固定大小的缓冲区交给输出端（Windows的waveOut设备、WAV文件或空输出）。
+ *
+ *          游戏线程与混音线程之间只有一个单生产者单消费者的无锁环：投递只写一个槽位和一个原子序号，
+ *          不分配内存、不加锁、不等待；环满时事件被丢弃并计数。混音线程在启动时准备好全部缓冲区，
+ *          稳定运行时同样不分配内存
+ */
+
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iosfwd>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @enum AudioCue
+ * @brief 音效种类
+ */
+enum AudioCue {
+    AUDIO_JUMP = 0,                 // 起跳
+    AUDIO_MILESTONE = 1,            // 每100分
+    AUDIO_SPEED_UP = 2,             // 速度等级提升（每200分，与updateGameSpeed一致，到12级为止）
+    AUDIO_GAME_OVER = 3,            // 碰撞
+    AUDIO_CUE_COUNT = 4
+};
+
+/**
+ * @struct AudioEvent
+ * @brief 投递给混音线程的事件
+ */
+struct AudioEvent {
+    uint64_t postedNs = 0;          // 投递时间（steady_clock）
+    uint32_t cue = 0;               // AudioCue
+};
+
+/**
+ * @class AudioEventQueue
+ * @brief 单生产者单消费者的无锁事件环
+ * @details 生产者只写head，消费者只写tail，两者各占一条缓存行；槽位在序号发布（release）之前写好
+ */
+class AudioEventQueue {
+public:
+    static const size_t CAPACITY = 256;         // 2的幂
+
+private:
+    AudioEvent slots[CAPACITY];
+    alignas(64) std::atomic<uint64_t> head;     // 下一个写入的序号
+    alignas(64) std::atomic<uint64_t> tail;     // 下一个读取的序号
+
+public:
+    AudioEventQueue() : head(0), tail(0) {}
+
+    /**
+     * @brief 写入一个事件（只能由一个线程调用）
+     * @return 环满时返回false
+     */
+    bool push(const AudioEvent& event);
+
+    /**
+     * @brief 取出一个事件（只能由一个线程调用）
+     * @return 环空时返回false
+     */
+    bool pop(AudioEvent& event);
+};
+
+/**
+ * @class AudioSink
+ * @brief 混音结果的输出端，只在混音线程中调用
+ */
+class AudioSink {
+public:
+    virtual ~AudioSink() {}
+
+    /**
+     * @brief 开始输出（16位单声道PCM）
+     */
+    virtual bool begin(int sampleRate, int bufferFrames) = 0;
+
+    /**
+     * @brief 写出一个缓冲区
+     */
+    virtual bool write(const int16_t* samples, size_t count) = 0;
+
+    /**
+     * @brief 结束输出
+     */
+    virtual void end() {}
+
+    /**
+     * @brief write是否按播放进度阻塞；否则由混音器按采样时钟自行定时
+     */
+    virtual bool paced() const { return false; }
+};
+
+/**
+ * @class NullAudioSink
+ * @brief 丢弃输出，只统计写出的样本数和非静音的缓冲区数
+ */
+class NullAudioSink : public AudioSink {
+private:
+    long long samples = 0;
+    long long audibleBuffers = 0;
+
+public:
+    bool begin(int sampleRate, int bufferFrames) override;
+    bool write(const int16_t* samples, size_t count) override;
+
+    long long getSampleCount() const { return samples; }
+    long long getAudibleBuffers() const { return audibleBuffers; }
+};
+
+/**
+ * @class WavFileAudioSink
+ * @brief 把输出写入WAV文件，end时补写RIFF头中的长度
+ */
+class WavFileAudioSink : public AudioSink {
+private:
+    std::string path;
+    FILE* file = nullptr;
+    uint32_t dataBytes = 0;
+    int sampleRate = 0;
+
+public:
+    explicit WavFileAudioSink(const std::string& path) : path(path) {}
+    ~WavFileAudioSink();
+
+    bool begin(int sampleRate, int bufferFrames) override;
+    bool write(const int16_t* samples, size_t count) override;
+    void end() override;
+};
+
+#ifdef _WIN32
+/**
+ * @class WaveOutAudioSink
+ * @brief Windows的waveOut设备输出（winmm），轮流提交几个缓冲区，write等待最早的一个播放完毕
+ */
+class WaveOutAudioSink : public AudioSink {
+public:
+    static const int QUEUED_BUFFERS = 3;
+
+private:
+    void* device = nullptr;                     // HWAVEOUT
+    std::vector<int16_t> buffers[QUEUED_BUFFERS];
+    std::vector<unsigned char> headers;         // QUEUED_BUFFERS个WAVEHDR
+    int next = 0;
+
+public:
+    ~WaveOutAudioSink();
+
+    bool begin(int sampleRate, int bufferFrames) override;
+    bool write(const int16_t* samples, size_t count) override;
+    void end() override;
+    bool paced() const override { return true; }
+};
+#endif
+
+/**
+ * @brief 读取16位单声道PCM的WAV文件
+ * @param sampleRate 输出：文件的采样率
+ */
+bool loadWav(const std::string& path, std::vector<int16_t>& pcm, int& sampleRate);
+
+/**
+ * @brief 合成音效的默认样本（短促的方波提示音，风格接近原版游戏）
+ */
+std::vector<int16_t> synthesizeCue(AudioCue cue, int sampleRate);
+
+/**
+ * @struct AudioStats
+ * @brief 混音统计
+ * @details 延迟指事件投递到其第一个样本所在的缓冲区交给输出端之间的时间；
+ *          设备输出还要再加上设备队列中的缓冲区时长
+ */
+struct AudioStats {
+    long long events = 0;           // 混音线程取到的事件数
+    long long dropped = 0;          // 环满被丢弃的事件数
+    long long stolenVoices = 0;     // 发声数满时被新事件顶替的发声
+    long long buffers = 0;          // 写出的缓冲区数
+    long long lateBuffers = 0;      // 错过采样时钟截止时间的缓冲区数
+    double bufferMs = 0;            // 一个缓冲区的时长
+    double meanLatencyMs = 0;
+    double p99LatencyMs = 0;
+    double maxLatencyMs = 0;
+};
+
+/**
+ * @class AudioMixer
+ * @brief 事件驱动的混音器
+ * @details 样本在start之前载入；post可以在游戏线程中任意调用。混音线程每个缓冲区周期先取出所有事件，
+ *          为每个事件分配一个发声（最多MAX_VOICES个，满时顶替播放进度最靠后的一个），
+ *          再以32位累加、饱和截断为16位
+ */
+class AudioMixer {
+public:
+    static const int MAX_VOICES = 8;
+    static const size_t LATENCY_CAPACITY = 65536;   // 保留的延迟样本数，超出后循环覆盖
+
+private:
+    /**
+     * @struct Voice
+     * @brief 一个正在播放的样本
+     */
+    struct Voice {
+        const int16_t* data = nullptr;
+        size_t length = 0;
+        size_t position = 0;
+        uint64_t postedNs = 0;
+        bool active = false;
+        bool started = false;       // 第一个缓冲区已写出（已记录延迟）
+    };
+
+    int sampleRate;
+    int bufferFrames;
+    std::vector<int16_t> clips[AUDIO_CUE_COUNT];
+    AudioEventQueue queue;
+    std::atomic<long long> dropped;
+
+    AudioSink* sink;
+    std::thread mixerThread;
+    std::atomic<bool> running;
+
+    // 以下只由混音线程访问（stop之后可读）
+    Voice voices[MAX_VOICES];
+    std::vector<int32_t> accumulator;
+    std::vector<int16_t> output;
+    std::vector<uint32_t> latencyUs;            // 循环记录的延迟（微秒）
+    long long latencySamples = 0;
+    double latencySumMs = 0;
+    AudioStats stats;
+
+    void run();
+    void startVoice(const AudioEvent& event);
+    void mixBuffer();
+
+public:
+    /**
+     * @param sampleRate 采样率
+     * @param bufferFrames 每个缓冲区的样本数（决定混音周期和延迟上限）
+     */
+    AudioMixer(int sampleRate = 22050, int bufferFrames = 256);
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    /**
+     * @brief 载入所有音效的合成样本
+     */
+    void loadDefaultClips();
+
+    /**
+     * @brief 替换一个音效的样本（只能在start之前调用）
+     */
+    void setClip(AudioCue cue, const std::vector<int16_t>& pcm);
+
+    /**
+     * @brief 启动混音线程
+     * @return 输出端begin失败返回false
+     */
+    bool start(AudioSink* target);
+
+    /**
+     * @brief 停止混音线程并结束输出
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 投递一个音效事件（游戏线程调用，无锁、不分配内存）
+     * @return 环满被丢弃时返回false
+     */
+    bool post(AudioCue cue);
+
+    int getSampleRate() const { return sampleRate; }
+
+    /**
+     * @brief 统计（混音线程运行时只有dropped是准确的，其余在stop之后读取）
+     */
+    AudioStats getStats() const;
+
+    /**
+     * @brief 输出事件数、丢弃数和延迟统计
+     */
+    void report(std::ostream& out) const;
+};
+
+#endif // AUDIO_MIXER_H
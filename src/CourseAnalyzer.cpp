@@ -0,0 +1,191 @@
+/**
+ * @file CourseAnalyzer.cpp
+ * @brief 赛道可解性分析器实现文件
+ * @details 状态编号、后继缓存、逐帧的状态集合推进和生成记录的读写
+ */
+
+#include "CourseAnalyzer.h"
+#include <algorithm>
+#include <fstream>
+
+// ==================== CompactStateSet类实现 ====================
+
+CompactStateSet::CompactStateSet(size_t capacity) : keys(capacity, 0), values(capacity, -1), count(0) {}
+
+size_t CompactStateSet::slot(uint64_t key) const {
+    // Fibonacci散列，容量始终为2的幂
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (keys.size() - 1);
+}
+
+int CompactStateSet::find(uint64_t key) const {
+    for (size_t i = slot(key);; i = (i + 1) & (keys.size() - 1)) {
+        if (keys[i] == key) return values[i];
+        if (keys[i] == 0) return -1;
+    }
+}
+
+void CompactStateSet::insert(uint64_t key, int value) {
+    if ((count + 1) * 2 > keys.size()) {
+        grow();
+    }
+    size_t i = slot(key);
+    while (keys[i] != 0 && keys[i] != key) {
+        i = (i + 1) & (keys.size() - 1);
+    }
+    if (keys[i] == 0) count++;
+    keys[i] = key;
+    values[i] = value;
+}
+
+void CompactStateSet::grow() {
+    std::vector<uint64_t> oldKeys(keys.size() * 2, 0);
+    std::vector<int> oldValues(values.size() * 2, -1);
+    oldKeys.swap(keys);
+    oldValues.swap(values);
+    count = 0;
+    for (size_t i = 0; i < oldKeys.size(); i++) {
+        if (oldKeys[i] != 0) {
+            insert(oldKeys[i], oldValues[i]);
+        }
+    }
+}
+
+// ==================== CourseAnalyzer类实现 ====================
+
+CourseAnalyzer::CourseAnalyzer(const DifficultyProfile& profile) : profile(profile) {}
+
+/**
+ * @brief 压缩恐龙状态
+ * @details 高32位为y的原始位，16-31位为velocityY（起跳速度和重力都是整数，velocityY始终为整数），
+ *          第2、1位为跳跃、下蹲标志，第0位恒为1保证键不为0。x和地面高度对所有状态相同，不参与编码
+ */
+uint64_t CourseAnalyzer::stateKey(const Dinosaur& dino) {
+    uint16_t velocity = (uint16_t)(int16_t)(int)toFloat(dino.getVelocityY());
+    return ((uint64_t)rawBits(dino.getY()) << 32) | ((uint64_t)velocity << 16) |
+           ((uint64_t)dino.getIsJumping() << 2) | ((uint64_t)dino.getIsDucking() << 1) | 1;
+}
+
+int CourseAnalyzer::intern(const Dinosaur& dino) {
+    uint64_t key = stateKey(dino);
+    int id = ids.find(key);
+    if (id >= 0) return id;
+
+    id = (int)states.size();
+    ids.insert(key, id);
+    states.push_back(dino);
+    successors.push_back({{-1, -1, -1}});
+    lastSeen.push_back(-1);
+    return id;
+}
+
+int CourseAnalyzer::successor(int id, int input) {
+    int next = successors[id][input];
+    if (next < 0) {
+        Dinosaur dino = states[id];   // 先复制：intern可能让states重新分配
+        applyPlayerInput(dino, input);
+        dino.update();
+        next = intern(dino);
+        successors[id][input] = next;
+    }
+    return next;
+}
+
+/**
+ * @brief 逐帧推进存活状态集合
+ * @details 每帧的顺序与DinoGame::update相同：输入和Dinosaur::update -> 生成 -> 清理 -> 移动 -> 碰撞检测。
+ *          候选状态用lastSeen去重，每个不同的后继状态每帧只做一次碰撞检测
+ */
+template <class SpawnSource>
+AnalysisResult CourseAnalyzer::run(SpawnSource&& spawnAt, int frames) {
+    AnalysisResult result;
+    result.frames = frames;
+
+    ObstacleWorld obstacles;
+    std::vector<int> alive(1, intern(Dinosaur()));
+    std::vector<int> candidates;
+    std::fill(lastSeen.begin(), lastSeen.end(), -1);
+
+    for (int frame = 0; frame < frames; frame++) {
+        candidates.clear();
+        for (int id : alive) {
+            for (int input = 0; input < INPUT_COUNT; input++) {
+                int next = successor(id, input);
+                if (lastSeen[next] != frame) {
+                    lastSeen[next] = frame;
+                    candidates.push_back(next);
+                }
+            }
+        }
+        result.expansions += (long long)alive.size() * INPUT_COUNT;
+
+        ScheduledSpawn spawn;
+        if (spawnAt(frame, spawn)) {
+            obstacles.spawn(spawn);
+        }
+        obstacles.removeOffscreen();
+        obstacles.update(profile.speedAt(frame));
+
+        alive.clear();
+        for (int id : candidates) {
+            if (!obstacles.checkCollision(states[id])) {
+                alive.push_back(id);
+            }
+        }
+        result.peakStates = std::max(result.peakStates, alive.size());
+
+        if (alive.empty()) {
+            result.survivable = false;
+            result.deathFrame = frame;
+            break;
+        }
+    }
+    return result;
+}
+
+AnalysisResult CourseAnalyzer::analyzeSeed(uint64_t seed, int frames) {
+    ObstacleSchedule schedule(seed, profile);
+    return run([&](int frame, ScheduledSpawn& spawn) { return schedule.spawnAt(frame, spawn); }, frames);
+}
+
+AnalysisResult CourseAnalyzer::analyzeSpawns(const std::vector<ScheduledSpawn>& spawns, int frames) {
+    size_t next = 0;
+    return run([&](int frame, ScheduledSpawn& spawn) {
+        while (next < spawns.size() && spawns[next].frame < frame) {
+            next++;
+        }
+        if (next < spawns.size() && spawns[next].frame == frame) {
+            spawn = spawns[next++];
+            return true;
+        }
+        return false;
+    }, frames);
+}
+
+// ==================== 生成记录读写 ====================
+
+bool loadSpawns(const std::string& path, std::vector<ScheduledSpawn>& spawns) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    spawns.clear();
+    ScheduledSpawn spawn;
+    int kind;
+    while (in >> spawn.frame >> kind >> spawn.height >> spawn.count) {
+        if (kind < 0 || kind >= OBSTACLE_KIND_COUNT) return false;
+        spawn.kind = (ObstacleKind)kind;
+        spawns.push_back(spawn);
+    }
+    if (!in.eof()) return false;
+
+    std::stable_sort(spawns.begin(), spawns.end(),
+        [](const ScheduledSpawn& a, const ScheduledSpawn& b) { return a.frame < b.frame; });
+    return true;
+}
+
+bool saveSpawns(const std::string& path, const std::vector<ScheduledSpawn>& spawns) {
+    std::ofstream out(path);
+    for (const ScheduledSpawn& spawn : spawns) {
+        out << spawn.frame << ' ' << (int)spawn.kind << ' ' << spawn.height << ' ' << spawn.count << '\n';
+    }
+    return (bool)out;
+}
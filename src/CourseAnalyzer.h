@@ -0,0 +1,109 @@
+/**
+ * @file CourseAnalyzer.h
+ * @brief 赛道可解性分析器头文件
+ * @details 对一条赛道（种子或录制的生成记录）逐帧推进所有可达的恐龙状态，
+ *          求出无论如何操作都会死亡的最早帧，或者证明赛道可以存活到指定帧数
+ */
+
+#ifndef COURSE_ANALYZER_H
+#define COURSE_ANALYZER_H
+
+#include "OptimizedDinoGame.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class CompactStateSet
+ * @brief 恐龙状态键到状态编号的开放寻址哈希表
+ * @details 键是64位压缩状态（见CourseAnalyzer::stateKey），0表示空槽；线性探测，负载超过1/2时扩容
+ */
+class CompactStateSet {
+private:
+    std::vector<uint64_t> keys;
+    std::vector<int> values;
+    size_t count;
+
+    size_t slot(uint64_t key) const;
+    void grow();
+
+public:
+    explicit CompactStateSet(size_t capacity = 64);
+
+    /**
+     * @return 键对应的编号，不存在时返回-1
+     */
+    int find(uint64_t key) const;
+
+    void insert(uint64_t key, int value);
+    size_t size() const { return count; }
+};
+
+/**
+ * @struct AnalysisResult
+ * @brief 一条赛道的分析结果
+ */
+struct AnalysisResult {
+    bool survivable = true;         // 是否存在存活到frames帧的操作序列
+    int deathFrame = -1;            // 不可避免的死亡帧（此时分数为deathFrame+1），可存活时为-1
+    int frames = 0;                 // 分析的帧数上限
+    size_t peakStates = 0;          // 单帧最多的存活状态数
+    long long expansions = 0;       // 状态×输入的展开次数
+};
+
+/**
+ * @class CourseAnalyzer
+ * @brief 赛道可解性分析器
+ * @details 障碍物只取决于种子和帧数，因此可以在唯一一条障碍物时间线上推进恐龙状态集合：
+ *          每帧对每个存活状态尝试所有输入，用Dinosaur::update得到后继状态，
+ *          去重后以ObstacleWorld::checkCollision剔除碰撞的状态，集合为空的帧就是不可避免的死亡帧。
+ *
+ *          恐龙的x固定，状态由(y, velocityY, 跳跃, 下蹲)决定，可达状态只有一次跳跃弧线上的几十个。
+ *          状态经哈希表编号后，后继关系按(编号, 输入)缓存，与赛道无关，同一个分析器分析多个种子时共享
+ */
+class CourseAnalyzer {
+private:
+    DifficultyProfile profile;
+    CompactStateSet ids;                                    // 状态键 -> 编号
+    std::vector<Dinosaur> states;                           // 编号 -> 状态
+    std::vector<std::array<int, INPUT_COUNT>> successors;   // 编号 -> 各输入的后继编号（-1为未计算）
+    std::vector<int> lastSeen;                              // 编号 -> 最近一次进入候选集合的帧，用于每帧去重
+
+    static uint64_t stateKey(const Dinosaur& dino);
+    int intern(const Dinosaur& dino);
+    int successor(int id, int input);
+
+    template <class SpawnSource>
+    AnalysisResult run(SpawnSource&& spawnAt, int frames);
+
+public:
+    explicit CourseAnalyzer(const DifficultyProfile& profile = DifficultyProfile());
+
+    /**
+     * @brief 分析由种子生成的赛道
+     * @param frames 帧数上限（分析第0..frames-1帧）
+     */
+    AnalysisResult analyzeSeed(uint64_t seed, int frames);
+
+    /**
+     * @brief 分析录制的生成记录（按帧排序），速度等级仍按难度曲线计算
+     */
+    AnalysisResult analyzeSpawns(const std::vector<ScheduledSpawn>& spawns, int frames);
+
+    size_t getStateCount() const { return states.size(); }
+};
+
+/**
+ * @brief 读取文本格式的生成记录，每行“帧 种类 高度 株数”
+ * @return 文件能否打开且格式正确
+ */
+bool loadSpawns(const std::string& path, std::vector<ScheduledSpawn>& spawns);
+
+/**
+ * @brief 以loadSpawns的格式写出生成记录
+ */
+bool saveSpawns(const std::string& path, const std::vector<ScheduledSpawn>& spawns);
+
+#endif // COURSE_ANALYZER_H
@@ -0,0 +1,112 @@
+/**
+ * @file DayNightPalette.cpp
+ * @brief 昼夜调色板实现文件
+ * @details 渐变表的预计算、进度推进和背景色的设置
+ */
+
+#include "DayNightPalette.h"
+#include <algorithm>
+#ifndef DINO_HEADLESS
+#include <graphics.h>
+#include <ege.h>
+#endif
+
+namespace {
+
+// 两端的颜色与原先硬切换时的颜色相同
+const uint32_t DAY_COLORS[PALETTE_ROLE_COUNT] = {
+    0xFFFFFF,   // 背景：白色
+    0x646464,   // 地面：RGB(100, 100, 100)
+    0x505050,   // 地面纹理：RGB(80, 80, 80)
+    0xC8C8C8,   // 云朵：RGB(200, 200, 200)
+    0x000000,   // 恐龙和障碍物：黑色
+    0xFFFFFF,   // 飞鸟的翅膀和眼睛：白色
+    0x000000    // 分数文字：黑色
+};
+
+const uint32_t NIGHT_COLORS[PALETTE_ROLE_COUNT] = {
+    0x323232,   // 背景：RGB(50, 50, 50)
+    0x646464,
+    0x505050,
+    0xC8C8C8,
+    0x000000,
+    0xFFFFFF,
+    0xFFFFFF    // 分数文字：白色
+};
+
+/**
+ * @brief 按通道线性插值，t = step / steps，四舍五入到整数
+ */
+uint32_t blend(uint32_t from, uint32_t to, int step, int steps) {
+    uint32_t result = 0;
+    for (int shift = 0; shift <= 16; shift += 8) {
+        int a = (int)((from >> shift) & 0xFF);
+        int b = (int)((to >> shift) & 0xFF);
+        int c = a + ((b - a) * step * 2 + (b >= a ? steps : -steps)) / (steps * 2);
+        result |= (uint32_t)c << shift;
+    }
+    return result;
+}
+
+/**
+ * @struct GradientTable
+ * @brief 预先计算的渐变表
+ */
+struct GradientTable {
+    uint32_t colors[DayNightPalette::GRADIENT_STEPS + 1][PALETTE_ROLE_COUNT];
+
+    GradientTable() {
+        for (int step = 0; step <= DayNightPalette::GRADIENT_STEPS; step++) {
+            for (int role = 0; role < PALETTE_ROLE_COUNT; role++) {
+                colors[step][role] = blend(DAY_COLORS[role], NIGHT_COLORS[role], step, DayNightPalette::GRADIENT_STEPS);
+            }
+        }
+    }
+};
+
+const GradientTable& sharedGradient() {
+    static const GradientTable table;
+    return table;
+}
+
+}  // namespace
+
+DayNightPalette::DayNightPalette(int frames)
+    : gradient(sharedGradient().colors), transitionFrames(std::max(1, frames)), progress(0), night(false), row(0),
+      appliedRow(-1) {}
+
+void DayNightPalette::setTransitionFrames(int frames) {
+    frames = std::max(1, frames);
+    progress = (int)((long long)progress * frames / transitionFrames);
+    transitionFrames = frames;
+    row = progress * GRADIENT_STEPS / transitionFrames;
+}
+
+void DayNightPalette::reset(bool toNight) {
+    night = toNight;
+    progress = toNight ? transitionFrames : 0;
+    row = toNight ? GRADIENT_STEPS : 0;
+}
+
+/**
+ * @details 进度每帧向目标移动1，行号为progress * GRADIENT_STEPS / transitionFrames（向下取整，
+ *          两端各自精确落在第0行和最后一行）；渐变中途目标反转时从当前进度原路返回
+ */
+bool DayNightPalette::update() {
+    int target = night ? transitionFrames : 0;
+    if (progress == target) return false;
+    progress += progress < target ? 1 : -1;
+    int next = progress * GRADIENT_STEPS / transitionFrames;
+    if (next == row) return false;
+    row = next;
+    return true;
+}
+
+bool DayNightPalette::applyBackground() {
+    if (row == appliedRow) return false;
+    appliedRow = row;
+#ifndef DINO_HEADLESS
+    setbkcolor_f(gradient[row][PALETTE_SKY]);
+#endif
+    return true;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file DayNightPalette.h
+ * @brief 昼夜调色板头文件
+ * @details 昼夜切换时，背景、地面、云朵、恐龙和障碍物、分数文字的颜色在若干帧内渐变，而不是在一帧内硬切换。
+ *          各角色颜色的渐变表在构造时一次算好，每帧只前进一格进度并查表；
+ *          渲染时各图层按角色取当前行的颜色，背景色只在行变化时才交给图形库
+ */
+
+#ifndef DAY_NIGHT_PALETTE_H
+#define DAY_NIGHT_PALETTE_H
+
+#include <cstdint>
+
+/**
+ * @enum PaletteRole
+ * @brief 调色板中的颜色角色
+ */
+enum PaletteRole {
+    PALETTE_SKY = 0,            // 背景色（cleardevice填充）
+    PALETTE_GROUND,             // 地面
+    PALETTE_GROUND_MARK,        // 地面滚动纹理
+    PALETTE_CLOUD,              // 云朵
+    PALETTE_SPRITE,             // 恐龙和障碍物的主体
+    PALETTE_SPRITE_DETAIL,      // 飞鸟的翅膀和眼睛
+    PALETTE_TEXT,               // 分数文字
+    PALETTE_ROLE_COUNT
+};
+
+/**
+ * @class DayNightPalette
+ * @brief 昼夜渐变调色板
+ * @details 渐变表共GRADIENT_STEPS + 1行（第0行白天，最后一行夜间），每行存放所有角色的0xRRGGBB颜色，
+ *          由所有实例共享（首次构造时计算）。
+ *          进度按帧推进，换算成行号后查表；渐变帧数不影响渐变表，只决定每隔几帧换一行。
+ *          一次渐变中颜色最多变化GRADIENT_STEPS次，行不变的帧与平常的帧完全相同
+ */
+class DayNightPalette {
+public:
+    static const int GRADIENT_STEPS = 32;
+    static const int DEFAULT_TRANSITION_FRAMES = 60;    // 30Hz下约2秒
+
+private:
+    const uint32_t (*gradient)[PALETTE_ROLE_COUNT];    // 共享的渐变表
+    int transitionFrames;       // 一次渐变的帧数（1为硬切换）
+    int progress;               // 0（白天）到transitionFrames（夜间）
+    bool night;                 // 目标模式
+    int row;                    // 当前使用的渐变表行
+    int appliedRow;             // 上一次交给图形库背景色时的行（-1表示尚未设置）
+
+public:
+    explicit DayNightPalette(int transitionFrames = DEFAULT_TRANSITION_FRAMES);
+
+    /**
+     * @brief 设置渐变帧数（小于等于1时为硬切换），当前进度按比例换算
+     */
+    void setTransitionFrames(int frames);
+    int getTransitionFrames() const { return transitionFrames; }
+
+    /**
+     * @brief 立即切换到白天或夜间（新的一局开始时使用，不经过渐变）
+     */
+    void reset(bool night);
+
+    /**
+     * @brief 设置目标模式，之后每次update向目标推进一帧
+     */
+    void setNight(bool night) { this->night = night; }
+    bool isNight() const { return night; }
+
+    /**
+     * @brief 推进一帧
+     * @return 使用的渐变表行是否变化
+     */
+    bool update();
+
+    /**
+     * @brief 是否正在渐变
+     */
+    bool isTransitioning() const { return progress != (night ? transitionFrames : 0); }
+
+    int getRow() const { return row; }
+
+    /**
+     * @brief 当前行中一个角色的颜色（0xRRGGBB）
+     */
+    uint32_t color(PaletteRole role) const { return gradient[row][role]; }
+
+    /**
+     * @brief 渐变表中的颜色（基准程序和检查使用）
+     */
+    uint32_t gradientColor(int row, PaletteRole role) const { return gradient[row][role]; }
+
+    /**
+     * @brief 行变化后把背景色交给图形库（在cleardevice之前调用）
+     * @return 是否设置了背景色
+     * @details 随后的cleardevice会重画整个画布，因此用不替换已有像素的setbkcolor_f，且只在行变化时调用
+     */
+    bool applyBackground();
+};
+
+#endif // DAY_NIGHT_PALETTE_H
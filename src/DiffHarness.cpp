@@ -0,0 +1,500 @@
+/**
+ * @file DiffHarness.cpp
+ * @brief 差分对照工具实现文件
+ * @details 各引擎的适配、状态比较、随机按键策略、重放和用例缩减
+ */
+
+#include "DiffHarness.h"
+#include "CourseAnalyzer.h"
+#include "DinoTrainer.h"
+#include "OptimizedDinoGame.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+// ==================== 状态采集 ====================
+
+/**
+ * @brief 以当前构建的数值类型解释原始位，用于输出
+ */
+float fromRawBits(uint32_t raw) {
+#ifdef DINO_FIXED_POINT
+    return Fixed16::fromRaw((int32_t)raw).toFloat();
+#else
+    float value;
+    std::memcpy(&value, &raw, sizeof(value));
+    return value;
+#endif
+}
+
+void captureDino(const Dinosaur& dino, EngineState& state) {
+    state.dinoY = rawBits(dino.getY());
+    state.dinoVelocityY = rawBits(dino.getVelocityY());
+    state.jumping = dino.getIsJumping();
+    state.ducking = dino.getIsDucking();
+}
+
+void captureWorld(const ObstacleWorld& world, EngineState& state) {
+    state.obstacles.clear();
+    for (int kind = 0; kind < OBSTACLE_KIND_COUNT; kind++) {
+        const ObstaclePool& p = world.pool((ObstacleKind)kind);
+        for (size_t i = 0; i < p.size(); i++) {
+            state.obstacles.push_back(EngineObstacle{kind, rawBits(p.x[i]), rawBits(p.y[i]), rawBits(p.width[i]),
+                                                     rawBits(p.height[i]), p.animationFrame[i], p.animationCounter[i]});
+        }
+    }
+    std::sort(state.obstacles.begin(), state.obstacles.end());
+}
+
+void captureReference(const ReferenceEngine& engine, EngineState& state) {
+    state.frame = engine.getFrameCount();
+    state.score = engine.getScore();
+    state.gameSpeed = engine.getGameSpeed();
+    state.gameOver = engine.getIsGameOver();
+    state.night = engine.getIsNightMode();
+    state.dinoY = rawBits(engine.getDinoY());
+    state.dinoVelocityY = rawBits(engine.getDinoVelocityY());
+    state.jumping = engine.getIsJumping();
+    state.ducking = engine.getIsDucking();
+    state.obstacles.clear();
+    for (const ReferenceEngine::Body& body : engine.getObstacles()) {
+        state.obstacles.push_back(EngineObstacle{(int)body.kind, rawBits(body.x), rawBits(body.y), rawBits(body.width),
+                                                 rawBits(body.height), body.wing, body.animationCounter % 5});
+    }
+    std::sort(state.obstacles.begin(), state.obstacles.end());
+}
+
+// ==================== 引擎适配 ====================
+
+/**
+ * @class ReferenceSimulation
+ * @brief 参考引擎自身（与自己对照，用于检查工具和测量参考引擎的速度）
+ */
+class ReferenceSimulation : public SimulationEngine {
+private:
+    ReferenceEngine engine;
+
+public:
+    const char* name() const override { return "reference"; }
+    void reset(uint64_t seed) override { engine.reset(seed); }
+    void press(int input) override { engine.press(input); }
+    void step() override { engine.step(); }
+    bool isGameOver() const override { return engine.getIsGameOver(); }
+    void capture(EngineState& state) const override { captureReference(engine, state); }
+};
+
+/**
+ * @class GameSimulation
+ * @brief 无界面的DinoGame，按键经由handleKey
+ */
+class GameSimulation : public SimulationEngine {
+protected:
+    std::unique_ptr<DinoGame> game;
+
+public:
+    GameSimulation() : game(new DinoGame()) {}
+
+    const char* name() const override { return "game"; }
+    void reset(uint64_t seed) override { game->initialize(seed); }
+
+    void press(int input) override {
+        if (game->getIsGameOver()) return;   // 结束后的按键用于重开，对照在结束时停止
+        if (input == INPUT_JUMP_KEY) {
+            game->handleKey(' ');
+        } else if (input == INPUT_DUCK_KEY) {
+            game->handleKey('s');
+        }
+    }
+
+    void step() override { game->update(); }
+    bool isGameOver() const override { return game->getIsGameOver(); }
+
+    void capture(EngineState& state) const override {
+        state.frame = game->getFrameCount();
+        state.score = game->getCurrentScore();
+        state.gameSpeed = game->getGameSpeed();
+        state.gameOver = game->getIsGameOver();
+        state.night = game->getIsNightMode();
+        captureDino(game->getPlayer(), state);
+        captureWorld(game->getObstacles(), state);
+    }
+};
+
+/**
+ * @class FaultySimulation
+ * @brief 故意注入错误的DinoGame：帧号模50余49时的跳跃键被吞掉
+ * @details 只有按键序列恰好在这些帧跳跃时才会分歧，用来确认工具能发现并缩减这类错误
+ */
+class FaultySimulation : public GameSimulation {
+public:
+    const char* name() const override { return "faulty"; }
+
+    void press(int input) override {
+        if (input == INPUT_JUMP_KEY && game->getFrameCount() % 50 == 49) return;
+        GameSimulation::press(input);
+    }
+};
+
+/**
+ * @class CourseSimulation
+ * @brief 训练器的TrainingCourse加与DinoGame共用的按键规则（applyPlayerInput）
+ * @details 分数即帧数，昼夜按updateGameSpeed的公式推出；TrainingCourse的种子是32位的
+ */
+class CourseSimulation : public SimulationEngine {
+private:
+    std::unique_ptr<TrainingCourse> course;
+    Dinosaur dino;
+    bool over;
+
+public:
+    CourseSimulation() : course(new TrainingCourse(0)), over(false) {}
+
+    const char* name() const override { return "course"; }
+
+    void reset(uint64_t seed) override {
+        course.reset(new TrainingCourse((uint32_t)seed));
+        dino.setPosition(50, 340 - 60);   // 与DinoGame::initialize相同，只重置位置
+        over = false;
+    }
+
+    void press(int input) override {
+        if (!over) applyPlayerInput(dino, input);
+    }
+
+    void step() override {
+        if (over) return;
+        dino.update();
+        course->spawnAndMove();
+        over = course->collides(dino);
+        course->finishFrame();
+    }
+
+    bool isGameOver() const override { return over; }
+
+    void capture(EngineState& state) const override {
+        state.frame = course->getFrame();
+        state.score = course->getFrame();
+        state.gameSpeed = course->getGameSpeed();
+        state.gameOver = over;
+        state.night = (state.score / 700) % 2 == 1;
+        captureDino(dino, state);
+        captureWorld(course->getObstacles(), state);
+    }
+};
+
+// ==================== 按键策略 ====================
+
+/**
+ * @class InputPolicy
+ * @brief 由种子决定的按键策略
+ * @details 前方障碍物还差若干帧到达时跳跃（能从下面钻过的飞鸟则下蹲），障碍物过去后起身，
+ *          另以一定概率随机按键。反应帧数和噪声比例按种子变化，既有很快死亡的局，也有跑满帧数上限的局
+ */
+class InputPolicy {
+private:
+    std::mt19937_64 rng;
+    float reactFrames;              // 障碍物还差多少帧到达时起跳
+    unsigned noisePermille;
+
+public:
+    explicit InputPolicy(uint64_t seed) : rng(seed * 0x9E3779B97F4A7C15ull + 1) {
+        reactFrames = (float)(6 + rng() % 4);
+        noisePermille = (unsigned)(rng() % 10);
+    }
+
+    int choose(const ReferenceEngine& engine) {
+        unsigned roll = (unsigned)(rng() % 1000);
+        if (roll < noisePermille) {
+            return roll < noisePermille / 2 ? INPUT_JUMP_KEY : INPUT_DUCK_KEY;
+        }
+
+        const float dinoX = toFloat(engine.getDinoX());
+        const float dinoRight = dinoX + toFloat(engine.getDinoWidth());
+        const ReferenceEngine::Body* nearest = nullptr;
+        for (const ReferenceEngine::Body& body : engine.getObstacles()) {
+            float bottom = toFloat(body.y) + toFloat(body.height);
+            if (toFloat(body.x) + toFloat(body.width) < dinoX || bottom <= 280) continue;   // 已经过去或从头顶飞过
+            if (!nearest || toFloat(body.x) < toFloat(nearest->x)) {
+                nearest = &body;
+            }
+        }
+
+        const float step = 5 + engine.getGameSpeed() * 0.15f;
+        bool near = nearest && toFloat(nearest->x) - dinoRight < reactFrames * step;
+        bool highBird = near && toFloat(nearest->y) + toFloat(nearest->height) <= 310;   // 下蹲能躲过
+        if (engine.getIsDucking()) {
+            return highBird ? INPUT_NONE : INPUT_DUCK_KEY;   // 再按一次S起身
+        }
+        if (near && !engine.getIsJumping()) {
+            return highBird ? INPUT_DUCK_KEY : INPUT_JUMP_KEY;
+        }
+        return INPUT_NONE;
+    }
+};
+
+template <class Value>
+void appendField(std::ostringstream& out, const char* name, const Value& expected, const Value& actual) {
+    out << name << ": expected " << expected << ", got " << actual;
+}
+
+void appendNumField(std::ostringstream& out, const char* name, uint32_t expected, uint32_t actual) {
+    out << name << ": expected " << fromRawBits(expected) << " (0x" << std::hex << expected << "), got "
+        << fromRawBits(actual) << " (0x" << actual << std::dec << ")";
+}
+
+}  // namespace
+
+// ==================== 状态比较 ====================
+
+bool EngineObstacle::operator<(const EngineObstacle& other) const {
+    if (kind != other.kind) return kind < other.kind;
+    if (x != other.x) return x < other.x;
+    return y < other.y;
+}
+
+bool EngineObstacle::operator==(const EngineObstacle& other) const {
+    return kind == other.kind && x == other.x && y == other.y && width == other.width &&
+           height == other.height && wing == other.wing && phase == other.phase;
+}
+
+std::string describeDifference(const EngineState& expected, const EngineState& actual) {
+    std::ostringstream out;
+    if (expected.frame != actual.frame) {
+        appendField(out, "frame", expected.frame, actual.frame);
+    } else if (expected.score != actual.score) {
+        appendField(out, "score", expected.score, actual.score);
+    } else if (expected.gameOver != actual.gameOver) {
+        appendField(out, "game over", expected.gameOver, actual.gameOver);
+    } else if (expected.gameSpeed != actual.gameSpeed) {
+        appendField(out, "game speed", expected.gameSpeed, actual.gameSpeed);
+    } else if (expected.night != actual.night) {
+        appendField(out, "night mode", expected.night, actual.night);
+    } else if (expected.jumping != actual.jumping) {
+        appendField(out, "dino jumping", expected.jumping, actual.jumping);
+    } else if (expected.ducking != actual.ducking) {
+        appendField(out, "dino ducking", expected.ducking, actual.ducking);
+    } else if (expected.dinoY != actual.dinoY) {
+        appendNumField(out, "dino y", expected.dinoY, actual.dinoY);
+    } else if (expected.dinoVelocityY != actual.dinoVelocityY) {
+        appendNumField(out, "dino velocity", expected.dinoVelocityY, actual.dinoVelocityY);
+    } else if (expected.obstacles.size() != actual.obstacles.size()) {
+        appendField(out, "obstacle count", expected.obstacles.size(), actual.obstacles.size());
+    } else {
+        for (size_t i = 0; i < expected.obstacles.size(); i++) {
+            const EngineObstacle& e = expected.obstacles[i];
+            const EngineObstacle& a = actual.obstacles[i];
+            if (e == a) continue;
+            out << "obstacle " << i << " (kind " << e.kind << ") ";
+            if (e.kind != a.kind) {
+                appendField(out, "kind", e.kind, a.kind);
+            } else if (e.x != a.x) {
+                appendNumField(out, "x", e.x, a.x);
+            } else if (e.y != a.y) {
+                appendNumField(out, "y", e.y, a.y);
+            } else if (e.width != a.width) {
+                appendNumField(out, "width", e.width, a.width);
+            } else if (e.height != a.height) {
+                appendNumField(out, "height", e.height, a.height);
+            } else if (e.wing != a.wing) {
+                appendField(out, "wing", e.wing, a.wing);
+            } else {
+                appendField(out, "animation phase", e.phase, a.phase);
+            }
+            break;
+        }
+    }
+    return out.str();
+}
+
+// ==================== 引擎工厂 ====================
+
+std::unique_ptr<SimulationEngine> createEngine(const std::string& name) {
+    if (name == "reference") return std::unique_ptr<SimulationEngine>(new ReferenceSimulation());
+    if (name == "game") return std::unique_ptr<SimulationEngine>(new GameSimulation());
+    if (name == "course") return std::unique_ptr<SimulationEngine>(new CourseSimulation());
+    if (name == "faulty") return std::unique_ptr<SimulationEngine>(new FaultySimulation());
+    return nullptr;
+}
+
+const std::vector<std::string>& engineNames() {
+    static const std::vector<std::string> names = {"game", "course"};
+    return names;
+}
+
+// ==================== DiffHarness类实现 ====================
+
+DiffHarness::DiffHarness(const std::string& engineName, int compareEvery)
+    : engineName(engineName), compareEvery(std::max(1, compareEvery)) {}
+
+Divergence DiffHarness::compareNow(const ReferenceEngine& reference, const SimulationEngine& candidate, int frame) const {
+    EngineState expected, actual;
+    captureReference(reference, expected);
+    candidate.capture(actual);
+    Divergence result;
+    result.detail = describeDifference(expected, actual);
+    if (!result.detail.empty()) {
+        result.found = true;
+        result.frame = frame;
+    }
+    return result;
+}
+
+Divergence DiffHarness::explore(uint64_t seed, int maxFrames, InputTrace& trace, DiffStats& stats) const {
+    ReferenceEngine reference;
+    std::unique_ptr<SimulationEngine> candidate = createEngine(engineName);
+    reference.reset(seed);
+    candidate->reset(seed);
+    InputPolicy policy(seed);
+    trace.seed = seed;
+    trace.inputs.clear();
+    stats.seeds++;
+
+    for (int frame = 0; frame < maxFrames; frame++) {
+        int input = policy.choose(reference);
+        trace.inputs.push_back((uint8_t)input);
+        reference.press(input);
+        candidate->press(input);
+        reference.step();
+        candidate->step();
+        stats.frames++;
+
+        bool end = reference.getIsGameOver() || candidate->isGameOver() || frame + 1 == maxFrames;
+        if (end || (frame + 1) % compareEvery == 0) {
+            Divergence d = compareNow(reference, *candidate, frame + 1);
+            if (d.found || end) return d;
+        }
+    }
+    return Divergence();
+}
+
+Divergence DiffHarness::replay(const InputTrace& trace, int every) const {
+    ReferenceEngine reference;
+    std::unique_ptr<SimulationEngine> candidate = createEngine(engineName);
+    reference.reset(trace.seed);
+    candidate->reset(trace.seed);
+    every = std::max(1, every);
+
+    const int frames = (int)trace.inputs.size();
+    for (int frame = 0; frame < frames; frame++) {
+        reference.press(trace.inputs[frame]);
+        candidate->press(trace.inputs[frame]);
+        reference.step();
+        candidate->step();
+
+        bool end = reference.getIsGameOver() || candidate->isGameOver() || frame + 1 == frames;
+        if (end || (frame + 1) % every == 0) {
+            Divergence d = compareNow(reference, *candidate, frame + 1);
+            if (d.found || end) return d;
+        }
+    }
+    return Divergence();
+}
+
+InputTrace DiffHarness::shrink(const InputTrace& failing) const {
+    InputTrace best = failing;
+    Divergence first = replay(best, 1);
+    if (!first.found) return best;
+    best.inputs.resize(first.frame);   // 第一帧分歧之后的按键无关
+
+    // 增量调试：把非空按键分成若干段，逐段尝试清除；成功就保留并重新截断，否则加细分段
+    auto reduce = [this](InputTrace& trace) {
+        size_t parts = 2;
+        for (;;) {
+            std::vector<size_t> pressed;
+            for (size_t i = 0; i < trace.inputs.size(); i++) {
+                if (trace.inputs[i] != INPUT_NONE) pressed.push_back(i);
+            }
+            if (pressed.empty()) return;
+            parts = std::min(parts, pressed.size());
+            size_t chunk = (pressed.size() + parts - 1) / parts;
+
+            bool progress = false;
+            for (size_t start = 0; start < pressed.size() && !progress; start += chunk) {
+                InputTrace candidate = trace;
+                for (size_t k = start; k < std::min(start + chunk, pressed.size()); k++) {
+                    candidate.inputs[pressed[k]] = INPUT_NONE;
+                }
+                Divergence d = replay(candidate, 1);
+                if (d.found) {
+                    candidate.inputs.resize(d.frame);
+                    trace = candidate;
+                    progress = true;
+                }
+            }
+            if (progress) {
+                parts = std::max<size_t>(2, parts - 1);
+            } else if (chunk == 1) {
+                return;
+            } else {
+                parts *= 2;
+            }
+        }
+    };
+    reduce(best);
+
+    // 分歧往往由最后一个按键触发：尝试把它提前，只保留之前的按键
+    for (size_t frame = 0; !best.inputs.empty() && frame + 1 < best.inputs.size(); frame++) {
+        InputTrace candidate = best;
+        candidate.inputs.resize(frame + 1);
+        candidate.inputs[frame] = best.inputs.back();
+        Divergence d = replay(candidate, 1);
+        if (d.found) {
+            candidate.inputs.resize(d.frame);
+            reduce(candidate);
+            best = candidate;
+            break;
+        }
+    }
+
+    // 更小的种子往往对应更短、更容易阅读的赛道
+    for (uint64_t seed = 0; seed < best.seed && seed < 1024; seed++) {
+        InputTrace candidate = best;
+        candidate.seed = seed;
+        Divergence d = replay(candidate, 1);
+        if (d.found) {
+            candidate.inputs.resize(d.frame);
+            reduce(candidate);
+            if (candidate.inputs.size() <= best.inputs.size()) {
+                best = candidate;
+            }
+            break;
+        }
+    }
+    return best;
+}
+
+// ==================== 复现用例读写 ====================
+
+bool saveTrace(const std::string& path, const InputTrace& trace) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "seed " << trace.seed << '\n' << "frames " << trace.inputs.size() << '\n';
+    for (size_t i = 0; i < trace.inputs.size(); i++) {
+        if (trace.inputs[i] != INPUT_NONE) {
+            out << i << ' ' << (int)trace.inputs[i] << '\n';
+        }
+    }
+    return (bool)out;
+}
+
+bool loadTrace(const std::string& path, InputTrace& trace) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string key;
+    size_t frames = 0;
+    if (!(in >> key >> trace.seed) || key != "seed" || !(in >> key >> frames) || key != "frames") {
+        return false;
+    }
+    trace.inputs.assign(frames, INPUT_NONE);
+    size_t frame;
+    int input;
+    while (in >> frame >> input) {
+        if (frame >= frames || input < 0 || input >= INPUT_COUNT) return false;
+        trace.inputs[frame] = (uint8_t)input;
+    }
+    return in.eof();
+}
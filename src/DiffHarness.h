@@ -0,0 +1,156 @@
+/**
+ * @file DiffHarness.h
+ * @brief 差分对照工具头文件
+ * @details 把待验证的引擎与冻结的参考引擎（ReferenceEngine）以相同的种子和按键序列并排运行，
+ *          每隔N帧比较完整状态；出现分歧时把种子和按键序列缩减为最小的复现用例
+ */
+
+#ifndef DIFF_HARNESS_H
+#define DIFF_HARNESS_H
+
+#include "ReferenceEngine.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @struct EngineObstacle
+ * @brief 比较用的障碍物状态（数值以原始位表示，要求逐位一致）
+ */
+struct EngineObstacle {
+    int kind;
+    uint32_t x, y, width, height;
+    int wing;           // 飞鸟翅膀位置
+    int phase;          // 动画相位（出生帧数模5）
+
+    bool operator<(const EngineObstacle& other) const;
+    bool operator==(const EngineObstacle& other) const;
+};
+
+/**
+ * @struct EngineState
+ * @brief 比较用的完整状态
+ * @details 障碍物按(种类, x, y)排序，各引擎内部的存放顺序不影响比较
+ */
+struct EngineState {
+    int frame = 0;
+    int score = 0;
+    int gameSpeed = 0;
+    bool gameOver = false;
+    bool night = false;
+    uint32_t dinoY = 0, dinoVelocityY = 0;
+    bool jumping = false, ducking = false;
+    std::vector<EngineObstacle> obstacles;
+};
+
+/**
+ * @brief 描述两个状态的第一处差异
+ * @return 一致时返回空字符串
+ */
+std::string describeDifference(const EngineState& expected, const EngineState& actual);
+
+/**
+ * @class SimulationEngine
+ * @brief 参与对照的引擎接口
+ * @details 每帧先press（可选）再step；reset开始新的一局，之后的结果只取决于种子和按键序列
+ */
+class SimulationEngine {
+public:
+    virtual ~SimulationEngine() {}
+    virtual const char* name() const = 0;
+    virtual void reset(uint64_t seed) = 0;
+    virtual void press(int input) = 0;
+    virtual void step() = 0;
+    virtual bool isGameOver() const = 0;
+    virtual void capture(EngineState& state) const = 0;
+};
+
+/**
+ * @brief 按名称创建引擎
+ * @param name reference（参考引擎本身）、game（无界面DinoGame）、course（训练器的TrainingCourse
+ *             加分析器的按键规则）、faulty（故意注入错误的DinoGame，用于验证工具本身）
+ * @return 未知名称返回nullptr
+ */
+std::unique_ptr<SimulationEngine> createEngine(const std::string& name);
+
+/**
+ * @brief 可用引擎名称列表（不含faulty）
+ */
+const std::vector<std::string>& engineNames();
+
+/**
+ * @struct InputTrace
+ * @brief 种子和逐帧按键（inputs[i]在第i帧step之前按下）
+ */
+struct InputTrace {
+    uint64_t seed = 0;
+    std::vector<uint8_t> inputs;
+};
+
+/**
+ * @struct Divergence
+ * @brief 一次对照的结果
+ */
+struct Divergence {
+    bool found = false;
+    int frame = -1;             // 发现分歧时已执行的帧数
+    std::string detail;         // 第一处差异
+};
+
+/**
+ * @struct DiffStats
+ * @brief 对照的工作量
+ */
+struct DiffStats {
+    long long seeds = 0;
+    long long frames = 0;       // 参考引擎推进的帧数
+};
+
+/**
+ * @class DiffHarness
+ * @brief 对照一个待验证引擎与参考引擎
+ * @details 一个实例只在一个线程中使用；多线程扫描时每个线程各自创建
+ */
+class DiffHarness {
+private:
+    std::string engineName;
+    int compareEvery;           // 每隔多少帧比较一次完整状态（任一方结束和最后一帧总会比较）
+
+    Divergence compareNow(const ReferenceEngine& reference, const SimulationEngine& candidate, int frame) const;
+
+public:
+    DiffHarness(const std::string& engineName, int compareEvery);
+
+    /**
+     * @brief 用种子决定的随机策略生成按键并同时推进两个引擎
+     * @param maxFrames 一局的帧数上限
+     * @param trace 输出实际使用的按键序列
+     */
+    Divergence explore(uint64_t seed, int maxFrames, InputTrace& trace, DiffStats& stats) const;
+
+    /**
+     * @brief 按给定的按键序列重放
+     * @param every 比较间隔（缩减时使用1，定位第一帧分歧）
+     */
+    Divergence replay(const InputTrace& trace, int every) const;
+
+    /**
+     * @brief 把出现分歧的用例缩减为最小复现
+     * @details 先截断到第一帧分歧，再以增量调试逐段去掉按键、把最后一个按键提前，最后尝试更小的种子；
+     *          每次缩减都以逐帧比较重新确认仍然分歧
+     */
+    InputTrace shrink(const InputTrace& failing) const;
+};
+
+/**
+ * @brief 写出复现用例，格式为“seed 种子”“frames 帧数”，随后每行“帧 按键”（只列出有按键的帧）
+ */
+bool saveTrace(const std::string& path, const InputTrace& trace);
+
+/**
+ * @brief 读取saveTrace写出的复现用例
+ */
+bool loadTrace(const std::string& path, InputTrace& trace);
+
+#endif // DIFF_HARNESS_H
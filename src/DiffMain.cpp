@@ -0,0 +1,209 @@
+/**
+ * @file DiffMain.cpp
+ * @brief 差分对照工具主程序
+ * @details 对一组连续种子（按线程并行）把待验证引擎与参考引擎并排运行；
+ *          发现分歧时缩减为最小复现用例、输出第一处差异并写出复现文件
+ *
+ * 用法：dino_diff [--engine game|course|faulty|reference|all] [--seed N] [--count N]
+ *                 [--frames N] [--every N] [--threads N] [--repro 文件] [--replay 文件]
+ *   --engine all（默认）依次对照game和course
+ *   --replay 按复现文件逐帧重放，不做随机扫描
+ */
+
+#include "DiffHarness.h"
+#include "OptimizedDinoGame.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* inputName(int input) {
+    switch (input) {
+    case INPUT_JUMP_KEY: return "jump";
+    case INPUT_DUCK_KEY: return "duck";
+    default: return "none";
+    }
+}
+
+void printTrace(const InputTrace& trace) {
+    std::cout << "  seed " << trace.seed << ", " << trace.inputs.size() << " frames";
+    int shown = 0;
+    for (size_t i = 0; i < trace.inputs.size(); i++) {
+        if (trace.inputs[i] == INPUT_NONE) continue;
+        std::cout << (shown == 0 ? ", inputs:" : "") << ' ' << inputName(trace.inputs[i]) << '@' << i;
+        if (++shown == 32) {
+            std::cout << " ...";
+            break;
+        }
+    }
+    std::cout << '\n';
+}
+
+/**
+ * @brief 对一个引擎扫描一组种子
+ * @return 是否发现分歧
+ */
+bool sweep(const std::string& engine, uint64_t firstSeed, int count, int frames, int every, int threads,
+           const std::string& reproPath) {
+    int threadCount = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+    threadCount = std::max(1, std::min(threadCount, count));
+
+    // 每个线程有自己的对照器，按原子计数器领取种子；分歧只保留种子最小的一个用于缩减
+    std::atomic<int> nextIndex(0);
+    std::atomic<int> divergent(0);
+    std::mutex lock;
+    DiffStats total;
+    InputTrace firstFailing;
+    Divergence firstDivergence;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&]() {
+            DiffHarness harness(engine, every);
+            DiffStats stats;
+            InputTrace trace;
+            for (int index = nextIndex++; index < count; index = nextIndex++) {
+                Divergence d = harness.explore(firstSeed + index, frames, trace, stats);
+                if (!d.found) continue;
+                divergent++;
+                std::lock_guard<std::mutex> guard(lock);
+                if (!firstDivergence.found || trace.seed < firstFailing.seed) {
+                    firstFailing = trace;
+                    firstDivergence = d;
+                }
+            }
+            std::lock_guard<std::mutex> guard(lock);
+            total.seeds += stats.seeds;
+            total.frames += stats.frames;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << engine << ": " << total.seeds << " seeds, " << total.frames << " frames in " << seconds << " s ("
+              << (seconds > 0 ? total.frames / seconds / 1e6 : 0) << " M frames/s, " << threadCount
+              << " threads), compared every " << every << " frames, " << divergent << " divergent\n";
+    if (!firstDivergence.found) {
+        return false;
+    }
+
+    std::cout << "  seed " << firstFailing.seed << " diverged by frame " << firstDivergence.frame << ": "
+              << firstDivergence.detail << '\n';
+    DiffHarness harness(engine, every);
+    InputTrace minimal = harness.shrink(firstFailing);
+    Divergence exact = harness.replay(minimal, 1);
+    std::cout << "  minimal repro, first divergence at frame " << exact.frame << ": " << exact.detail << '\n';
+    printTrace(minimal);
+    if (!reproPath.empty()) {
+        std::string path = reproPath;
+        if (path.size() > 4 && path.compare(path.size() - 4, 4, ".txt") == 0) {
+            path.insert(path.size() - 4, "-" + engine);
+        } else {
+            path += "-" + engine;
+        }
+        if (saveTrace(path, minimal)) {
+            std::cout << "  written to " << path << " (dino_diff --engine " << engine << " --replay " << path
+                      << ")\n";
+        } else {
+            std::cerr << "cannot write " << path << std::endl;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+/**
+ * @brief 差分对照主入口
+ * @return 参数错误、文件读写失败或发现分歧返回1，否则返回0
+ */
+int main(int argc, char** argv) {
+    std::string engine = "all";
+    uint64_t firstSeed = 1;
+    int count = 1000;
+    int frames = 5000;
+    int every = 60;
+    int threads = 0;
+    std::string reproPath = "dino_diff_repro.txt";
+    std::string replayPath;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::cerr << "missing value for " << arg << std::endl;
+            return 1;
+        }
+        if (std::strcmp(arg, "--engine") == 0) {
+            engine = value;
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            firstSeed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--count") == 0) {
+            count = std::atoi(value);
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            frames = std::atoi(value);
+        } else if (std::strcmp(arg, "--every") == 0) {
+            every = std::atoi(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--repro") == 0) {
+            reproPath = value;
+        } else if (std::strcmp(arg, "--replay") == 0) {
+            replayPath = value;
+        } else {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return 1;
+        }
+        i++;
+    }
+    if (frames <= 0 || count <= 0 || every <= 0) {
+        std::cerr << "--frames, --count and --every must be positive" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> engines;
+    if (engine == "all") {
+        engines = engineNames();
+    } else if (createEngine(engine)) {
+        engines.push_back(engine);
+    } else {
+        std::cerr << "unknown engine: " << engine << std::endl;
+        return 1;
+    }
+
+    bool diverged = false;
+    if (!replayPath.empty()) {
+        InputTrace trace;
+        if (!loadTrace(replayPath, trace)) {
+            std::cerr << "cannot read " << replayPath << std::endl;
+            return 1;
+        }
+        for (const std::string& name : engines) {
+            Divergence d = DiffHarness(name, 1).replay(trace, 1);
+            std::cout << name << ": ";
+            if (d.found) {
+                std::cout << "diverges at frame " << d.frame << ": " << d.detail << '\n';
+                diverged = true;
+            } else {
+                std::cout << "matches the reference for " << trace.inputs.size() << " frames\n";
+            }
+        }
+        return diverged ? 1 : 0;
+    }
+
+    for (const std::string& name : engines) {
+        diverged |= sweep(name, firstSeed, count, frames, every, threads, reproPath);
+    }
+    return diverged ? 1 : 0;
+}
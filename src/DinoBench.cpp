@@ -0,0 +1,877 @@
+/**
+ * @file DinoBench.cpp
+ * @brief 性能基准程序
+ * @details 在无图形界面下测量游戏核心各部分的每帧开销
+ *
+ * 用法：dino_bench ecs [帧数]     障碍物世界（组件数组）与虚函数继承体系的每帧开销对比
+ *       dino_bench pacer [帧数]   各帧节奏策略在模拟负载下的帧时间精度
+ *       dino_bench fixed [帧数]   Q16.16定点数与float模拟状态的每帧开销对比
+ *       dino_bench alloc [帧数]   稳态帧和重开过程零堆分配的自检
+ *       dino_bench dataset [帧数] 列式数据集的记录开销、压缩率和内存映射扫描吞吐
+ *       dino_bench telemetry [帧数] 共享内存遥测的每帧发布开销和并发读取的一致性
+ *       dino_bench audio [事件数] 音效事件的投递开销、零堆分配、事件到缓冲区延迟和WAV输出
+ *       dino_bench palette [帧数] 昼夜渐变表的端点和单调性、渐变时长，以及每帧查表相对一帧更新的开销
+ */
+
+#include "OptimizedDinoGame.h"
+#include "EpisodeDataset.h"
+#include "Telemetry.h"
+#include "AudioMixer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @struct BenchResult
+ * @brief 一次测量的结果
+ */
+struct BenchResult {
+    double nsPerFrame;      // 平均每帧耗时（纳秒）
+    long long collisions;   // 检测到碰撞的帧数，用于核对两种实现的结果一致
+    double meanAlive;       // 平均存活障碍物数
+};
+
+/**
+ * @brief 用虚函数继承体系创建障碍物（仙人掌丛按单株仙人掌处理，基准中不会生成）
+ */
+std::unique_ptr<Obstacle> createLegacyObstacle(const ScheduledSpawn& spawn) {
+    if (spawn.kind == OBSTACLE_BIRD) {
+        return std::make_unique<Bird>(800, spawn.height);
+    }
+    return std::make_unique<Cactus>(800, 340, spawn.height);
+}
+
+/**
+ * @brief 每30帧起跳一次的恐龙，使碰撞检测覆盖站立和跳跃两种状态
+ */
+template <class Num>
+void stepDino(BasicDinosaur<Num>& dino, int frame) {
+    if (frame % 30 == 0) {
+        dino.jump();
+    }
+    dino.update();
+}
+
+BenchResult runLegacy(const DifficultyProfile& profile, const std::vector<ScheduledSpawn>& spawns, int frames) {
+    std::vector<std::unique_ptr<Obstacle>> obstacles;
+    Dinosaur dino;
+    long long collisions = 0;
+    long long alive = 0;
+    size_t next = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        stepDino(dino, frame);
+        if (next < spawns.size() && spawns[next].frame == frame) {
+            obstacles.push_back(createLegacyObstacle(spawns[next++]));
+        }
+        obstacles.erase(
+            std::remove_if(obstacles.begin(), obstacles.end(),
+                [](const std::unique_ptr<Obstacle>& obs) { return obs->getX() < -50; }),
+            obstacles.end());
+        for (auto& obstacle : obstacles) {
+            obstacle->update(profile.speedAt(frame));
+        }
+        for (const auto& obstacle : obstacles) {
+            if (obstacle->checkCollision(dino)) {
+                collisions++;
+                break;
+            }
+        }
+        alive += obstacles.size();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return {ns / frames, collisions, (double)alive / frames};
+}
+
+BenchResult runWorld(const DifficultyProfile& profile, const std::vector<ScheduledSpawn>& spawns, int frames) {
+    ObstacleWorld obstacles;
+    Dinosaur dino;
+    long long collisions = 0;
+    long long alive = 0;
+    size_t next = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        stepDino(dino, frame);
+        if (next < spawns.size() && spawns[next].frame == frame) {
+            obstacles.spawn(spawns[next++]);
+        }
+        obstacles.removeOffscreen();
+        obstacles.update(profile.speedAt(frame));
+        if (obstacles.checkCollision(dino)) {
+            collisions++;
+        }
+        alive += obstacles.size();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return {ns / frames, collisions, (double)alive / frames};
+}
+
+/**
+ * @brief 障碍物世界与虚函数继承体系的对比
+ * @details 两种实现使用同一份生成计划（关闭仙人掌丛，保证种类一致）；
+ *          "game"为游戏默认密度，"dense"每帧生成一个障碍物，模拟大量实体的情况
+ */
+int benchEcs(int frames) {
+    DifficultyProfile gameProfile;
+    gameProfile.clusterMinSpeed = 1000;
+    DifficultyProfile denseProfile = gameProfile;
+    denseProfile.baseInterval = 1;
+    denseProfile.intervalPerLevel = 0;
+    denseProfile.minInterval = 1;
+
+    struct Workload { const char* name; DifficultyProfile profile; };
+    Workload workloads[] = {{"game", gameProfile}, {"dense", denseProfile}};
+
+    bool consistent = true;
+    for (const Workload& workload : workloads) {
+        ObstacleSchedule schedule(12345, workload.profile);
+        std::vector<ScheduledSpawn> spawns = schedule.spawnsBetween(0, frames - 1);  // 预先取出，不计入测量
+
+        BenchResult legacy = runLegacy(workload.profile, spawns, frames);
+        BenchResult world = runWorld(workload.profile, spawns, frames);
+        consistent = consistent && legacy.collisions == world.collisions;
+
+        std::cout << workload.name << " (" << world.meanAlive << " obstacles alive)\n"
+                  << "  virtual hierarchy: " << legacy.nsPerFrame << " ns/frame\n"
+                  << "  obstacle world:    " << world.nsPerFrame << " ns/frame"
+                  << "  (x" << legacy.nsPerFrame / world.nsPerFrame << ")\n"
+                  << "  collision frames:  " << legacy.collisions << " / " << world.collisions << std::endl;
+    }
+    return consistent ? 0 : 1;
+}
+
+/**
+ * @struct NumericResult
+ * @brief 一种数值类型的模拟结果
+ */
+struct NumericResult {
+    BenchResult bench;
+    uint64_t digest;        // 逐帧碰撞结果和最终障碍物坐标的FNV-1a摘要
+};
+
+/**
+ * @brief 以Num为数值类型运行恐龙和障碍物世界
+ * @details 与runWorld的帧顺序相同；摘要覆盖每帧的碰撞结果和结束时所有实体的原始坐标位，
+ *          定点数模式下摘要在任何平台和编译选项下都应相同
+ */
+template <class Num>
+NumericResult runNumeric(const DifficultyProfile& profile, const std::vector<ScheduledSpawn>& spawns, int frames) {
+    BasicObstacleWorld<Num> obstacles;
+    BasicDinosaur<Num> dino;
+    long long collisions = 0;
+    long long alive = 0;
+    uint64_t digest = 14695981039346656037ull;
+    size_t next = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        stepDino(dino, frame);
+        if (next < spawns.size() && spawns[next].frame == frame) {
+            obstacles.spawn(spawns[next++]);
+        }
+        obstacles.removeOffscreen();
+        obstacles.update(Num(profile.speedAt(frame)));
+        bool hit = obstacles.checkCollision(dino);
+        collisions += hit;
+        digest = (digest ^ (uint64_t)hit) * 1099511628211ull;
+        alive += obstacles.size();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    for (int kind = 0; kind < OBSTACLE_KIND_COUNT; kind++) {
+        const BasicObstaclePool<Num>& pool = obstacles.pool((ObstacleKind)kind);
+        for (size_t i = 0; i < pool.size(); i++) {
+            digest = (digest ^ rawBits(pool.x[i])) * 1099511628211ull;
+            digest = (digest ^ rawBits(pool.y[i])) * 1099511628211ull;
+        }
+    }
+    digest = (digest ^ rawBits(dino.getY())) * 1099511628211ull;
+    return {{ns / frames, collisions, (double)alive / frames}, digest};
+}
+
+/**
+ * @brief 定点数与浮点数模拟状态的对比
+ * @details 两种实例使用同一份生成计划和同一个起跳节奏。0.15的定点表示有约4e-5的舍入，
+ *          两者的坐标会逐渐产生亚像素差异，因此只要求碰撞帧数相差不超过1%
+ */
+int benchFixed(int frames) {
+    DifficultyProfile gameProfile;
+    DifficultyProfile denseProfile = gameProfile;
+    denseProfile.baseInterval = 1;
+    denseProfile.intervalPerLevel = 0;
+    denseProfile.minInterval = 1;
+
+    struct Workload { const char* name; DifficultyProfile profile; };
+    Workload workloads[] = {{"game", gameProfile}, {"dense", denseProfile}};
+
+    bool close = true;
+    for (const Workload& workload : workloads) {
+        ObstacleSchedule schedule(12345, workload.profile);
+        std::vector<ScheduledSpawn> spawns = schedule.spawnsBetween(0, frames - 1);
+
+        NumericResult floating = runNumeric<float>(workload.profile, spawns, frames);
+        NumericResult fixed = runNumeric<Fixed16>(workload.profile, spawns, frames);
+        long long diff = std::abs(floating.bench.collisions - fixed.bench.collisions);
+        close = close && diff * 100 <= std::max(1LL, floating.bench.collisions);
+
+        std::cout << workload.name << " (" << fixed.bench.meanAlive << " obstacles alive)\n"
+                  << "  float:    " << floating.bench.nsPerFrame << " ns/frame, digest " << std::hex
+                  << floating.digest << std::dec << "\n"
+                  << "  Q16.16:   " << fixed.bench.nsPerFrame << " ns/frame, digest " << std::hex
+                  << fixed.digest << std::dec << "  (x" << floating.bench.nsPerFrame / fixed.bench.nsPerFrame << ")\n"
+                  << "  collision frames: " << floating.bench.collisions << " / " << fixed.bench.collisions << std::endl;
+    }
+    return close ? 0 : 1;
+}
+
+/**
+ * @brief 帧节奏控制器的计时精度
+ * @details 每帧忙等0~50%周期的随机时长模拟游戏负载，检查帧时间中位数与目标周期的偏差：
+ *          固定帧率策略要求在2%以内，省电策略（只休眠）要求在10%以内。
+ *          用中位数而不是平均值，避免偶发的进程调度停顿掩盖控制器本身的精度
+ */
+int benchPacer(int frames) {
+    const PacingPolicy policies[] = {PACING_FIXED_30, PACING_FIXED_60, PACING_FIXED_120,
+                                     PACING_POWER_SAVING, PACING_UNCAPPED};
+    std::mt19937 rng(7);
+    bool accurate = true;
+
+    for (PacingPolicy policy : policies) {
+        FramePacer pacer(policy);
+        double periodMs = pacer.getTargetHz() > 0 ? 1000.0 / pacer.getTargetHz() : 1.0;
+        std::uniform_real_distribution<double> load(0.0, 0.5 * periodMs);
+        std::vector<double> frameMs;
+        auto last = std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame <= frames; frame++) {
+            auto busyUntil = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::milli>(load(rng)));
+            while (std::chrono::steady_clock::now() < busyUntil) {
+            }
+            pacer.waitForNextFrame();
+
+            auto now = std::chrono::steady_clock::now();
+            if (frame > 0) {
+                frameMs.push_back(std::chrono::duration<double, std::milli>(now - last).count());
+            }
+            last = now;
+        }
+        std::sort(frameMs.begin(), frameMs.end());
+        double medianMs = frameMs[frameMs.size() / 2];
+
+        pacer.report(std::cout);
+        if (pacer.getTargetHz() > 0) {
+            double error = std::abs(medianMs - periodMs) / periodMs;
+            double tolerance = policy == PACING_POWER_SAVING ? 0.10 : 0.02;
+            std::cout << "  median " << medianMs << " ms, error " << error * 100
+                      << "% (tolerance " << tolerance * 100 << "%)\n";
+            accurate = accurate && error <= tolerance;
+        }
+    }
+    return accurate ? 0 : 1;
+}
+
+/**
+ * @brief 稳态零堆分配自检
+ * @details 以无界面的DinoGame连续运行多局：每30帧按一次空格，游戏结束后按键重开。
+ *          第一局是预热，竞技场缓冲区、生成计划的内存池和组件数组的容量都在这一局中建立；
+ *          此后的每一帧以及每次重开都不应再经过全局operator new
+ */
+int benchAlloc(int frames) {
+    DinoGame game;
+    game.initialize();
+
+    bool warm = false;
+    int episodes = 1;
+    long long measuredFrames = 0;
+    AllocationCounts warmStart;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        if (game.getIsGameOver()) {
+            game.handleKey(' ');   // 延迟结束前按键无效
+            if (!game.getIsGameOver()) {
+                episodes++;
+                if (!warm) {
+                    warm = true;
+                    warmStart = heapAllocationCounts();   // 从第二局的重开之后开始计量
+                }
+            }
+        } else if (frame % 30 == 0) {
+            game.handleKey(' ');
+        }
+        game.update();
+        measuredFrames += warm;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    AllocationCounts now = heapAllocationCounts();
+    long long steadyAllocations = now.allocations - warmStart.allocations;
+    long long steadyBytes = now.bytes - warmStart.bytes;
+
+    game.getAllocationTracker().report(std::cout);
+    std::cout << "episodes: " << episodes << ", " << ns / frames << " ns/frame\n"
+              << "arena: capacity " << game.getArena().getCapacity() << " bytes, current episode "
+              << game.getArena().getEpisodeCounts().allocations << " allocations ("
+              << game.getArena().getEpisodeCounts().bytes << " bytes), overflow "
+              << game.getArena().getOverflowCounts().allocations << '\n'
+              << "after warm-up: " << measuredFrames << " frames, " << steadyAllocations
+              << " heap allocations (" << steadyBytes << " bytes)" << std::endl;
+    return warm && steadyAllocations == 0 ? 0 : 1;
+}
+
+/**
+ * @brief 以benchAlloc的方式驱动无界面游戏若干帧
+ * @return 游戏结束（碰撞）的次数
+ */
+long long driveGame(DinoGame& game, int frames) {
+    long long deaths = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        if (game.getIsGameOver()) {
+            game.handleKey(' ');
+        } else if (frame % 30 == 0) {
+            game.handleKey(' ');
+        }
+        bool wasOver = game.getIsGameOver();
+        game.update();
+        deaths += !wasOver && game.getIsGameOver();
+    }
+    return deaths;
+}
+
+/**
+ * @struct RunSum
+ * @brief 按游程求和的结果
+ */
+struct RunSum {
+    double total = 0;
+    long long runs = 0;
+    long long rows = 0;
+};
+
+template <class T>
+RunSum sumRuns(const ColumnRuns<T>& view) {
+    RunSum sum;
+    for (ColumnRun<T> run : view) {
+        sum.total += (double)run.value * run.length;
+        sum.rows += run.length;
+    }
+    sum.runs = (long long)view.count;
+    return sum;
+}
+
+/**
+ * @brief 当前线程消耗的CPU时间（纳秒）；没有线程CPU时钟的平台上退化为单调时钟
+ */
+double threadCpuNs() {
+#ifndef _WIN32
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+#else
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <class T>
+double sumColumn(const ColumnView<T>& view) {
+    double sum = 0;
+    for (T value : view) {
+        sum += (double)value;
+    }
+    return sum;
+}
+
+/**
+ * @brief 列式数据集基准
+ * @details 先测量不记录时的模拟速度，再在记录数据集的同时运行相同帧数；
+ *          再让同一种子的两局游戏在driveGame中按块交替推进、一局记录一局不记录，
+ *          模拟线程上记录的开销（各块CPU时间之比的中位数）超过模拟一帧的MAX_RECORD_OVERHEAD（5%）时返回非0；
+ *          随后内存映射读回，原样存储的列按切片、游程编码的列按游程扫描（都不拷贝），并核对：
+ *          行数一致、每局帧号从0连续递增、奖励为-1的行数等于碰撞次数、游程总长等于块的行数、
+ *          扫描结果与解码成逐行数组后相同
+ */
+int benchDataset(int frames) {
+    const int RECORD_BLOCK_FRAMES = 4096;
+    const std::string path = (std::filesystem::temp_directory_path() / "dino_bench_dataset.dcol").string();
+
+    // 不记录与记录交替运行三轮，各取最快的一轮，抵消机器负载的波动
+    double simulateNs = 0, simulateThreadNs = 0, recordNs = 0;
+    long long deaths = 0;
+    DatasetWriter writer;
+    for (int round = 0; round < 3; round++) {
+        {
+            DinoGame game;
+            game.initialize();
+            double threadStart = threadCpuNs();
+            auto start = std::chrono::steady_clock::now();
+            driveGame(game, frames);
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            double threadNs = threadCpuNs() - threadStart;
+            simulateNs = round == 0 ? ns : std::min(simulateNs, ns);
+            simulateThreadNs = round == 0 ? threadNs : std::min(simulateThreadNs, threadNs);
+        }
+
+        if (!writer.open(path)) {
+            std::cerr << "cannot write " << path << std::endl;
+            return 1;
+        }
+        DinoGame game;
+        game.setRecorder(&writer);
+        game.initialize();
+        auto start = std::chrono::steady_clock::now();
+        deaths = driveGame(game, frames);
+        bool written = writer.close();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (!written) {
+            std::cerr << "dataset write failed" << std::endl;
+            return 1;
+        }
+        recordNs = round == 0 ? ns : std::min(recordNs, ns);
+    }
+
+    // 模拟线程上的记录开销：同一种子的两局游戏在driveGame中按块交替推进，一局记录、一局不记录，
+    // 模拟的工作相同；各块只计本线程的CPU时间（后台线程的转置、编码和写盘不计入），
+    // 取每对块的开销比例的中位数，排除偶发的调度和缓存干扰
+    double overhead;
+    {
+        const std::string probePath = path + ".probe";   // 写到单独的文件，不覆盖上面记录的数据集
+        DatasetWriter probeWriter;
+        if (!probeWriter.open(probePath)) {
+            std::cerr << "cannot write " << probePath << std::endl;
+            return 1;
+        }
+        DinoGame plain, recorded;
+        recorded.setRecorder(&probeWriter);
+        const uint64_t seed = (uint64_t)time(nullptr);
+        plain.initialize(seed);
+        recorded.initialize(seed);
+        std::vector<double> ratios;
+        for (int done = 0; done < frames; done += RECORD_BLOCK_FRAMES) {
+            const int n = std::min(RECORD_BLOCK_FRAMES, frames - done);
+            double start = threadCpuNs();
+            driveGame(plain, n);
+            double middle = threadCpuNs();
+            driveGame(recorded, n);
+            double end = threadCpuNs();
+            ratios.push_back((end - middle) / std::max(middle - start, 1.0) - 1);
+        }
+        std::sort(ratios.begin(), ratios.end());
+        overhead = ratios[ratios.size() / 2];
+        probeWriter.close();
+        std::filesystem::remove(probePath);
+    }
+    const long long rows = writer.getRowCount();
+    long long rawBytes = 0;
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+        rawBytes += rows * datasetColumn(c).width;
+    }
+
+    // 模拟线程的记录开销（采集一行并暂存）不超过模拟一帧的MAX_RECORD_OVERHEAD
+    const double MAX_RECORD_OVERHEAD = 0.05;
+    double frameNs = simulateThreadNs / frames;
+    bool cheap = overhead <= MAX_RECORD_OVERHEAD;
+    std::cout << "simulate: " << frames / simulateNs * 1e3 << " M frames/s, " << frameNs << " ns/frame\n"
+              << "simulate + record: " << frames / recordNs * 1e3 << " M frames/s including the writer thread, "
+              << rows << " rows, " << (recordNs - simulateNs) / std::max<long long>(rows, 1) << " ns/row\n"
+              << "simulation thread: recording adds " << overhead * frameNs << " ns/frame, " << overhead * 100
+              << "% (median of " << RECORD_BLOCK_FRAMES << "-frame blocks, limit " << MAX_RECORD_OVERHEAD * 100 << "%)"
+              << (cheap ? "" : " EXCEEDED") << "\n"
+              << "stored " << writer.getStoredBytes() << " bytes for " << rawBytes << " raw bytes (ratio "
+              << (double)rawBytes / std::max<long long>(writer.getStoredBytes(), 1) << ")\n";
+
+    DatasetReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "cannot read " << path << std::endl;
+        std::filesystem::remove(path);
+        return 1;
+    }
+
+    std::vector<uint8_t> scratch8;
+    std::vector<uint32_t> scratch32;
+    std::vector<int32_t> scratchI32;
+    std::vector<float> scratchF32;
+
+    // 逐列扫描全部数据，都不拷贝：原样存储的列直接求和切片，游程编码的列按游程求和
+    double checksum = 0;
+    int zeroCopy = 0, runColumns = 0;
+    long long rawScanBytes = 0, runCount = 0, runRows = 0;
+    bool runsCoverRows = true;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t chunk = 0; chunk < reader.getChunkCount(); chunk++) {
+        for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+            if (reader.rawColumn(chunk, c) == nullptr) continue;
+            zeroCopy++;
+            rawScanBytes += (long long)reader.getChunkRows(chunk) * datasetColumn(c).width;
+            switch (datasetColumn(c).type) {
+            case COLUMN_U8:  checksum += sumColumn(reader.column(chunk, c, scratch8)); break;
+            case COLUMN_U32: checksum += sumColumn(reader.column(chunk, c, scratch32)); break;
+            case COLUMN_I32: checksum += sumColumn(reader.column(chunk, c, scratchI32)); break;
+            case COLUMN_F32: checksum += sumColumn(reader.column(chunk, c, scratchF32)); break;
+            }
+        }
+    }
+    double rawScanNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (size_t chunk = 0; chunk < reader.getChunkCount(); chunk++) {
+        for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+            if (reader.getCodec(chunk, c) != CODEC_RLE) continue;
+            RunSum sum;
+            switch (datasetColumn(c).type) {
+            case COLUMN_U8:  sum = sumRuns(reader.runs<uint8_t>(chunk, c)); break;
+            case COLUMN_U32: sum = sumRuns(reader.runs<uint32_t>(chunk, c)); break;
+            case COLUMN_I32: sum = sumRuns(reader.runs<int32_t>(chunk, c)); break;
+            case COLUMN_F32: sum = sumRuns(reader.runs<float>(chunk, c)); break;
+            }
+            checksum += sum.total;
+            runCount += sum.runs;
+            runRows += sum.rows;
+            runColumns++;
+            runsCoverRows = runsCoverRows && sum.rows == reader.getChunkRows(chunk);
+        }
+    }
+    double runScanNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    // 对照：把所有列解码成逐行数组后的和应与上面相同（求和顺序不同，允许舍入误差）
+    double decodedChecksum = 0;
+    for (size_t chunk = 0; chunk < reader.getChunkCount(); chunk++) {
+        for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+            switch (datasetColumn(c).type) {
+            case COLUMN_U8:  decodedChecksum += sumColumn(reader.column(chunk, c, scratch8)); break;
+            case COLUMN_U32: decodedChecksum += sumColumn(reader.column(chunk, c, scratch32)); break;
+            case COLUMN_I32: decodedChecksum += sumColumn(reader.column(chunk, c, scratchI32)); break;
+            case COLUMN_F32: decodedChecksum += sumColumn(reader.column(chunk, c, scratchF32)); break;
+            }
+        }
+    }
+    bool checksumMatches = std::fabs(checksum - decodedChecksum) <= 1e-9 * std::max(1.0, std::fabs(decodedChecksum));
+
+    // 一致性：帧号连续、碰撞次数
+    bool consistent = reader.getRowCount() == rows;
+    long long deathRows = 0;
+    uint32_t previousEpisode = 0;
+    int32_t previousFrame = -1;
+    for (size_t chunk = 0; chunk < reader.getChunkCount() && consistent; chunk++) {
+        ColumnView<uint32_t> episode = reader.column(chunk, COL_EPISODE, scratch32);
+        ColumnView<int32_t> frame = reader.column(chunk, COL_FRAME, scratchI32);
+        ColumnView<float> reward = reader.column(chunk, COL_REWARD, scratchF32);
+        for (size_t i = 0; i < frame.size; i++) {
+            bool next = episode[i] == previousEpisode ? frame[i] == previousFrame + 1 : frame[i] == 0;
+            consistent = consistent && next;
+            previousEpisode = episode[i];
+            previousFrame = frame[i];
+            deathRows += reward[i] < 0;
+        }
+    }
+    consistent = consistent && deathRows == deaths && runsCoverRows && checksumMatches;
+
+    size_t columnChunks = reader.getChunkCount() * DATASET_COLUMN_COUNT;
+    std::cout << "scan: " << reader.getChunkCount() << " chunks, " << zeroCopy << " of " << columnChunks
+              << " column chunks raw, " << rawScanBytes / rawScanNs << " GB/s zero-copy\n"
+              << "runs: " << runColumns << " column chunks, " << runCount << " runs for " << runRows << " rows, "
+              << runRows / runScanNs << " G rows/s without decoding (checksum " << checksum
+              << (checksumMatches ? ", matches decoded" : ", DIFFERS from decoded") << ")\n"
+              << "episodes: " << deaths << " deaths, " << deathRows << " terminal rows: "
+              << (consistent ? "consistent" : "MISMATCH") << std::endl;
+
+    reader.close();
+    std::filesystem::remove(path);
+    return consistent && cheap ? 0 : 1;
+}
+
+/**
+ * @brief 发布第frame帧的合成快照，每8帧附带一条事件；字段都由帧号决定，供读者校验
+ */
+void publishSynthetic(TelemetryPublisher& publisher, uint64_t frame) {
+    TelemetrySnapshot snapshot;
+    snapshot.frame = frame;
+    snapshot.episode = (uint32_t)(frame / 1000);
+    snapshot.score = (int32_t)frame;
+    snapshot.highScore = (int32_t)(frame * 3);
+    snapshot.gameSpeed = (int32_t)(frame % 13);
+    snapshot.obstaclesAlive = (int32_t)(frame % 7);
+    snapshot.dinoY = (float)(frame % 1000);
+    publisher.publish(snapshot);
+    if (frame % 8 == 0) {
+        publisher.event(TELEMETRY_INPUT, (int32_t)frame, frame);
+    }
+}
+
+bool snapshotConsistent(const TelemetrySnapshot& s) {
+    return s.score == (int32_t)s.frame && s.highScore == (int32_t)(s.frame * 3) &&
+           s.gameSpeed == (int32_t)(s.frame % 13) && s.obstaclesAlive == (int32_t)(s.frame % 7) &&
+           s.episode == (uint32_t)(s.frame / 1000) && s.dinoY == (float)(s.frame % 1000);
+}
+
+/**
+ * @brief 共享内存遥测基准
+ * @details 第一阶段读者只映射不读取（相当于停顿的读者），测量每帧发布的平均开销，要求低于1微秒；
+ *          第二阶段另一个线程持续读取快照和事件，检查没有读到撕裂的快照、事件按序且内容完整
+ */
+int benchTelemetry(int frames) {
+    const std::string name = "/dino_bench_telemetry_" + std::to_string(telemetryNowNs());
+    TelemetryPublisher publisher;
+    if (!publisher.open(name)) {
+        std::cerr << "cannot create shared memory " << name << std::endl;
+        return 1;
+    }
+    TelemetryReader stalled;
+    stalled.open(name);
+
+    uint64_t frame = 1;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++, frame++) {
+        publishSynthetic(publisher, frame);
+    }
+    double publishNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    std::atomic<bool> done(false);
+    long long reads = 0, torn = 0, busy = 0, eventsRead = 0, badEvents = 0;
+    uint64_t dropped = 0;
+    std::thread readerThread([&]() {
+        TelemetryReader reader;
+        if (!reader.open(name)) {
+            torn = -1;
+            return;
+        }
+        uint64_t cursor = reader.eventHead();
+        uint64_t lastEventFrame = 0;
+        TelemetryEvent events[64];
+        while (!done.load(std::memory_order_relaxed)) {
+            TelemetrySnapshot s;
+            if (reader.readSnapshot(s)) {
+                reads++;
+                torn += !snapshotConsistent(s);
+            } else {
+                busy++;
+            }
+            size_t n = reader.readEvents(cursor, events, 64, dropped);
+            for (size_t i = 0; i < n; i++) {
+                bool ok = events[i].type == TELEMETRY_INPUT && events[i].frame == (uint64_t)events[i].value &&
+                          events[i].frame % 8 == 0 && events[i].frame > lastEventFrame;
+                badEvents += !ok;
+                lastEventFrame = events[i].frame;
+            }
+            eventsRead += (long long)n;
+        }
+    });
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++, frame++) {
+        publishSynthetic(publisher, frame);
+    }
+    double contendedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    done = true;
+    readerThread.join();
+    publisher.close();
+
+    bool fast = publishNs < 1000;
+    bool consistent = torn == 0 && badEvents == 0 && reads > 0;
+    std::cout << "publish (reader stalled): " << publishNs << " ns/frame" << (fast ? "" : " (over 1 us)") << '\n'
+              << "publish (reader polling): " << contendedNs << " ns/frame\n"
+              << "reader: " << reads << " snapshots, " << torn << " torn, " << busy << " busy; "
+              << eventsRead << " events, " << badEvents << " bad, " << dropped << " dropped" << std::endl;
+    return fast && consistent ? 0 : 1;
+}
+
+/**
+ * @brief 音效混音器自检
+ * @details 以随机间隔（0.5-8.5毫秒，相对混音周期均匀分布）投递事件，再连续投递一批，混音线程按实时采样时钟
+ *          输出到空输出端；投递期间整个进程不应有堆分配，事件都应被混音，延迟不应超过一个缓冲区周期太多。
+ *          最后把两个音效混音写入WAV文件再读回，确认文件格式和内容
+ */
+int benchAudio(int events) {
+    AudioMixer mixer;
+    mixer.loadDefaultClips();
+    NullAudioSink sink;
+    if (!mixer.start(&sink)) {
+        std::cerr << "cannot start mixer" << std::endl;
+        return 1;
+    }
+
+    std::mt19937 rng(7);
+    double postNs = 0;
+    long long posted = 0;
+    AllocationCounts before = heapAllocationCounts();
+    for (int i = 0; i < events; i++) {
+        std::this_thread::sleep_for(std::chrono::microseconds(500 + rng() % 8000));
+        auto t0 = std::chrono::steady_clock::now();
+        posted += mixer.post((AudioCue)(i % AUDIO_CUE_COUNT));
+        postNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    }
+    // 连续投递一批（缓存是热的），不超过事件环容量的一半
+    const int burst = (int)AudioEventQueue::CAPACITY / 2;
+    auto burstStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < burst; i++) {
+        posted += mixer.post(AUDIO_JUMP);
+    }
+    double burstNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - burstStart).count();
+    AllocationCounts after = heapAllocationCounts();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));   // 让最后的事件进入缓冲区
+    mixer.stop();
+    mixer.report(std::cout);
+    AudioStats s = mixer.getStats();
+
+    const std::string path = (std::filesystem::temp_directory_path() / "dino_bench_audio.wav").string();
+    std::vector<int16_t> pcm;
+    int rate = 0;
+    {
+        WavFileAudioSink wav(path);
+        AudioMixer offline;
+        offline.loadDefaultClips();
+        offline.start(&wav);
+        offline.post(AUDIO_JUMP);
+        offline.post(AUDIO_GAME_OVER);
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        offline.stop();
+    }
+    bool wavRead = loadWav(path, pcm, rate);
+    std::filesystem::remove(path);
+    int peak = 0;
+    for (int16_t v : pcm) {
+        peak = std::max(peak, std::abs((int)v));
+    }
+    const size_t gameOverLength = synthesizeCue(AUDIO_GAME_OVER, mixer.getSampleRate()).size();
+
+    long long allocations = after.allocations - before.allocations;
+    bool delivered = posted == events + burst && s.events == posted && s.dropped == 0 && sink.getAudibleBuffers() > 0;
+    bool prompt = s.p99LatencyMs <= 2 * s.bufferMs;
+    bool wavOk = wavRead && rate == mixer.getSampleRate() && pcm.size() >= gameOverLength && peak > 0;
+    std::cout << "post: " << postNs / events << " ns/event after idle, " << burstNs / burst << " ns/event in a burst, "
+              << allocations << " heap allocations while posting\n"
+              << "null sink: " << sink.getSampleCount() << " samples, " << sink.getAudibleBuffers()
+              << " audible buffers\n"
+              << "wav sink: " << (wavRead ? "read back " : "unreadable ") << pcm.size() << " samples at " << rate
+              << " Hz, peak " << peak << std::endl;
+    return delivered && prompt && wavOk && allocations == 0 ? 0 : 1;
+}
+
+/**
+ * @brief 昼夜调色板自检
+ * @details 渐变表两端应与原先硬切换的颜色相同，背景逐行变暗、文字逐行变亮；
+ *          一次渐变恰好持续设定的帧数并经过全部行，中途反转时原路返回，渐变帧数为0时一帧完成。
+ *          开销按每帧推进一次并取出全部角色颜色计算，与无界面游戏一帧的更新开销比较
+ */
+int benchPalette(int frames) {
+    DayNightPalette palette;
+    const int last = DayNightPalette::GRADIENT_STEPS;
+    bool endpoints = palette.gradientColor(0, PALETTE_SKY) == 0xFFFFFF &&
+                     palette.gradientColor(0, PALETTE_TEXT) == 0x000000 &&
+                     palette.gradientColor(last, PALETTE_SKY) == 0x323232 &&
+                     palette.gradientColor(last, PALETTE_TEXT) == 0xFFFFFF;
+    bool monotonic = true;
+    for (int row = 1; row <= last; row++) {
+        monotonic = monotonic && palette.gradientColor(row, PALETTE_SKY) < palette.gradientColor(row - 1, PALETTE_SKY) &&
+                    palette.gradientColor(row, PALETTE_TEXT) > palette.gradientColor(row - 1, PALETTE_TEXT) &&
+                    palette.gradientColor(row, PALETTE_GROUND) == palette.gradientColor(0, PALETTE_GROUND);
+    }
+
+    // 一次完整的渐变：帧数和换行次数
+    palette.setNight(true);
+    int fadeFrames = 0, rowChanges = 0;
+    while (palette.isTransitioning()) {
+        rowChanges += palette.update();
+        fadeFrames++;
+    }
+    bool fullFade = fadeFrames == palette.getTransitionFrames() && rowChanges == last && palette.getRow() == last;
+
+    // 渐变中途反转，回到白天
+    palette.setNight(false);
+    for (int i = 0; i < palette.getTransitionFrames() / 3; i++) palette.update();
+    palette.setNight(true);
+    for (int i = 0; i < palette.getTransitionFrames() / 3; i++) palette.update();
+    bool reversed = !palette.isTransitioning() && palette.getRow() == last;
+
+    DayNightPalette hard(0);
+    hard.setNight(true);
+    bool hardSwitch = hard.update() && !hard.isTransitioning() && hard.getRow() == last;
+
+    // 开销：每700帧切换一次目标（与游戏一致），每帧推进并取出全部角色颜色
+    DayNightPalette timed;
+    uint32_t checksum = 0;
+    long long transitionFrames = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        timed.setNight((frame / 700) % 2 == 1);
+        if (timed.isTransitioning()) {
+            timed.update();
+            transitionFrames++;
+        }
+        for (int role = 0; role < PALETTE_ROLE_COUNT; role++) {
+            checksum += timed.color((PaletteRole)role);
+        }
+    }
+    double paletteNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    DinoGame game;
+    game.initialize();
+    start = std::chrono::steady_clock::now();
+    driveGame(game, frames);
+    double gameNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    std::cout << "gradient: " << last + 1 << " rows, sky " << std::hex << palette.gradientColor(0, PALETTE_SKY) << " -> "
+              << palette.gradientColor(last, PALETTE_SKY) << ", text " << palette.gradientColor(0, PALETTE_TEXT)
+              << " -> " << palette.gradientColor(last, PALETTE_TEXT) << std::dec << (monotonic ? ", monotonic" : ", NOT monotonic")
+              << '\n'
+              << "fade: " << fadeFrames << " frames, " << rowChanges << " row changes, reversal "
+              << (reversed ? "ok" : "FAILED") << ", hard switch " << (hardSwitch ? "ok" : "FAILED") << '\n'
+              << "cost: " << paletteNs << " ns/frame for the palette (" << transitionFrames << " of " << frames
+              << " frames fading, checksum " << checksum % 1000 << "), " << gameNs << " ns/frame for a game update ("
+              << paletteNs / gameNs * 100 << "%)" << std::endl;
+    return endpoints && monotonic && fullFade && reversed && hardSwitch ? 0 : 1;
+}
+
+}  // namespace
+
+/**
+ * @brief 基准程序主入口
+ * @return 未知基准返回2，结果不一致或超出精度要求返回1，否则返回0
+ */
+int main(int argc, char** argv) {
+    const char* name = argc > 1 ? argv[1] : "";
+    int frames = argc > 2 ? std::atoi(argv[2]) : 0;
+
+    if (std::strcmp(name, "ecs") == 0) {
+        return benchEcs(frames > 0 ? frames : 200000);
+    }
+    if (std::strcmp(name, "pacer") == 0) {
+        return benchPacer(frames > 0 ? frames : 120);
+    }
+    if (std::strcmp(name, "fixed") == 0) {
+        return benchFixed(frames > 0 ? frames : 200000);
+    }
+    if (std::strcmp(name, "alloc") == 0) {
+        return benchAlloc(frames > 0 ? frames : 200000);
+    }
+    if (std::strcmp(name, "dataset") == 0) {
+        return benchDataset(frames > 0 ? frames : 5000000);
+    }
+    if (std::strcmp(name, "telemetry") == 0) {
+        return benchTelemetry(frames > 0 ? frames : 5000000);
+    }
+    if (std::strcmp(name, "audio") == 0) {
+        return benchAudio(frames > 0 ? frames : 400);
+    }
+    if (std::strcmp(name, "palette") == 0) {
+        return benchPalette(frames > 0 ? frames : 1000000);
+    }
+
+    std::cerr << "usage: dino_bench ecs|pacer|fixed|alloc|dataset|telemetry|audio|palette [frames]" << std::endl;
+    return 2;
+}
@@ -0,0 +1,416 @@
+/**
+ * @file DinoTrainer.cpp
+ * @brief 神经进化训练器实现文件
+ * @details 赛道模拟、批量推理、多线程评估、遗传算子和种群存档
+ */
+
+#include "DinoTrainer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+// ==================== 动作映射 ====================
+
+/**
+ * @brief 把动作作用到恐龙上
+ * @details 动作是每帧保持的状态，而S键是切换：下蹲动作只在未下蹲时按一次S，
+ *          站立动作只在下蹲中按一次S起身；跳跃等同空格。规则本身都由applyPlayerInput决定
+ */
+void applyAgentAction(Dinosaur& dino, int action) {
+    switch (action) {
+    case ACTION_JUMP:
+        applyPlayerInput(dino, INPUT_JUMP_KEY);
+        break;
+    case ACTION_DUCK:
+        if (!dino.getIsDucking()) {
+            applyPlayerInput(dino, INPUT_DUCK_KEY);
+        }
+        break;
+    default:
+        if (dino.getIsDucking()) {
+            applyPlayerInput(dino, INPUT_DUCK_KEY);
+        }
+        break;
+    }
+}
+
+// ==================== TrainingCourse类实现 ====================
+
+TrainingCourse::TrainingCourse(uint32_t seed) : schedule(seed), frameCount(0), gameSpeed(5) {}
+
+/**
+ * @brief 生成并移动障碍物
+ * @details 与DinoGame::generateObstacle相同，从生成计划中取出当前帧的生成记录
+ */
+void TrainingCourse::spawnAndMove() {
+    ScheduledSpawn spawn;
+    if (schedule.spawnAt(frameCount, spawn)) {
+        obstacles.spawn(spawn);
+    }
+    obstacles.removeOffscreen();
+    obstacles.update(gameSpeed);
+}
+
+/**
+ * @brief 结束当前帧
+ * @details 本帧分数为frameCount+1，速度等级按DinoGame::updateGameSpeed的公式计算
+ */
+void TrainingCourse::finishFrame() {
+    frameCount++;
+    gameSpeed = schedule.getProfile().speedAt(frameCount);
+}
+
+bool TrainingCourse::collides(const Dinosaur& dino) const {
+    return obstacles.checkCollision(dino);
+}
+
+bool TrainingCourse::nextObstacle(const Dinosaur& dino, ObstacleView& view) const {
+    return obstacles.nearestAhead(toFloat(dino.getX()), view);  // 跳过已经被越过的障碍物
+}
+
+// ==================== NeuroTrainer类实现 ====================
+
+namespace {
+
+// 参数下标：W1[j][i]、b1[j]、W2[o][j]、b2[o]依次排列
+inline int w1Index(int j, int i) { return j * NeuroTrainer::INPUTS + i; }
+inline int b1Index(int j) { return NeuroTrainer::HIDDEN * NeuroTrainer::INPUTS + j; }
+inline int w2Index(int o, int j) {
+    return NeuroTrainer::HIDDEN * NeuroTrainer::INPUTS + NeuroTrainer::HIDDEN + o * NeuroTrainer::HIDDEN + j;
+}
+inline int b2Index(int o) {
+    return NeuroTrainer::HIDDEN * NeuroTrainer::INPUTS + NeuroTrainer::HIDDEN
+         + NeuroTrainer::OUTPUTS * NeuroTrainer::HIDDEN + o;
+}
+
+const char CHECKPOINT_MAGIC[8] = {'D', 'I', 'N', 'O', 'P', 'O', 'P', '1'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+}  // namespace
+
+/**
+ * @brief NeuroTrainer构造函数
+ * @details 按配置初始化随机种群，参数服从N(0, 0.5)
+ */
+NeuroTrainer::NeuroTrainer(const TrainerConfig& config)
+    : config(config), populationSize(std::max(2, config.populationSize)), generation(0), simulatedFrames(0), rng(config.seed) {
+    params.resize((size_t)PARAM_COUNT * populationSize);
+    fitness.assign(populationSize, 0.0f);
+
+    std::normal_distribution<float> init(0.0f, 0.5f);
+    for (auto& value : params) {
+        value = init(rng);
+    }
+}
+
+/**
+ * @brief 批量前向推理
+ * @details 对一批个体同时计算：外层循环遍历网络参数，内层循环遍历个体，
+ *          每个参数对应一段连续内存，乘加可以被编译器展开为SIMD指令
+ */
+void NeuroTrainer::forwardBatch(int begin, int count, BatchScratch& scratch) const {
+    const float* inputs = scratch.inputs.data();
+    float* hidden = scratch.hidden.data();
+    float* output = scratch.output.data();
+    int* actions = scratch.actions.data();
+
+    for (int j = 0; j < HIDDEN; j++) {
+        float* h = &hidden[(size_t)j * count];
+        const float* bias = &params[(size_t)b1Index(j) * populationSize + begin];
+        std::copy(bias, bias + count, h);
+        for (int i = 0; i < INPUTS; i++) {
+            const float* w = &params[(size_t)w1Index(j, i) * populationSize + begin];
+            const float* in = &inputs[(size_t)i * count];
+            for (int k = 0; k < count; k++) {
+                h[k] += w[k] * in[k];
+            }
+        }
+        for (int k = 0; k < count; k++) {
+            h[k] = std::tanh(h[k]);
+        }
+    }
+
+    for (int o = 0; o < OUTPUTS; o++) {
+        float* out = &output[(size_t)o * count];
+        const float* bias = &params[(size_t)b2Index(o) * populationSize + begin];
+        std::copy(bias, bias + count, out);
+        for (int j = 0; j < HIDDEN; j++) {
+            const float* w = &params[(size_t)w2Index(o, j) * populationSize + begin];
+            const float* h = &hidden[(size_t)j * count];
+            for (int k = 0; k < count; k++) {
+                out[k] += w[k] * h[k];
+            }
+        }
+    }
+
+    for (int k = 0; k < count; k++) {
+        int best = 0;
+        for (int o = 1; o < OUTPUTS; o++) {
+            if (output[(size_t)o * count + k] > output[(size_t)best * count + k]) {
+                best = o;
+            }
+        }
+        actions[k] = best;
+    }
+}
+
+/**
+ * @brief 在一条赛道上评估一段连续的个体
+ * @details 所有个体按帧同步推进：先批量推理得到动作，再更新各自的恐龙，
+ *          共享的赛道每帧只模拟一次，最后逐个检测碰撞。
+ *          个体的得分为死亡帧的分数（frameCount+1），存活到maxFrames则为maxFrames
+ */
+long long NeuroTrainer::evaluateRange(int begin, int end, uint32_t courseSeed, std::vector<float>& scores,
+                                      BatchScratch& scratch) const {
+    int count = end - begin;
+    std::vector<Dinosaur> dinos(count);
+    std::vector<char> alive(count, 1);
+    float* inputs = scratch.inputs.data();
+    TrainingCourse course(courseSeed);
+    int aliveCount = count;
+    long long frames = 0;
+
+    while (aliveCount > 0 && course.getFrame() < config.maxFrames) {
+        float speedInput = (course.getGameSpeed() - 5) / 7.0f;
+        for (int k = 0; k < count; k++) {
+            const Dinosaur& dino = dinos[k];
+            ObstacleView next;
+            bool hasNext = course.nextObstacle(dino, next);
+            float dinoY = toFloat(dino.getY());
+            inputs[0 * count + k] = (340 - 60 - dinoY) / 100.0f;
+            inputs[1 * count + k] = toFloat(dino.getVelocityY()) / 15.0f;
+            inputs[2 * count + k] = hasNext ? (next.x - toFloat(dino.getX()) - toFloat(dino.getWidth())) / 800.0f : 1.0f;
+            inputs[3 * count + k] = hasNext ? (340 - next.y) / 100.0f : 0.0f;
+            inputs[4 * count + k] = hasNext && next.kind == OBSTACLE_BIRD ? 1.0f : 0.0f;
+            inputs[5 * count + k] = speedInput;
+        }
+        forwardBatch(begin, count, scratch);
+
+        for (int k = 0; k < count; k++) {
+            if (alive[k]) {
+                applyAgentAction(dinos[k], scratch.actions[k]);
+                dinos[k].update();
+            }
+        }
+
+        course.spawnAndMove();
+
+        for (int k = 0; k < count; k++) {
+            if (alive[k] && course.collides(dinos[k])) {
+                alive[k] = 0;
+                aliveCount--;
+                scores[begin + k] += course.getFrame() + 1;
+            }
+        }
+
+        course.finishFrame();
+        frames++;
+    }
+
+    for (int k = 0; k < count; k++) {
+        if (alive[k]) {
+            scores[begin + k] += config.maxFrames;
+        }
+    }
+    return frames * count;
+}
+
+/**
+ * @brief 评估整个种群
+ * @details 种群按线程数切分为连续区间，每个线程依次在本代的所有赛道上评估自己的区间。
+ *          赛道种子由基础种子和代数决定，同一代的所有个体面对完全相同的障碍物序列
+ */
+void NeuroTrainer::evaluate() {
+    int threadCount = config.threads > 0 ? config.threads : (int)std::thread::hardware_concurrency();
+    threadCount = std::max(1, std::min(threadCount, populationSize));
+    int courses = std::max(1, config.coursesPerGeneration);
+
+    std::vector<float> scores(populationSize, 0.0f);
+    std::vector<long long> frames(threadCount, 0);
+    std::vector<std::thread> workers;
+    int chunk = (populationSize + threadCount - 1) / threadCount;
+    for (int t = 0; t < threadCount; t++) {
+        int begin = t * chunk;
+        int end = std::min(populationSize, begin + chunk);
+        if (begin >= end) break;
+        workers.emplace_back([this, t, begin, end, courses, &scores, &frames]() {
+            int count = end - begin;
+            BatchScratch scratch;
+            scratch.inputs.resize((size_t)INPUTS * count);
+            scratch.hidden.resize((size_t)HIDDEN * count);
+            scratch.output.resize((size_t)OUTPUTS * count);
+            scratch.actions.resize(count);
+            for (int c = 0; c < courses; c++) {
+                uint32_t courseSeed = config.seed * 7919u + (uint32_t)generation * 131u + (uint32_t)c;
+                frames[t] += evaluateRange(begin, end, courseSeed, scores, scratch);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (int g = 0; g < populationSize; g++) {
+        fitness[g] = scores[g] / courses;
+    }
+    simulatedFrames = std::accumulate(frames.begin(), frames.end(), 0LL);
+}
+
+/**
+ * @brief 产生下一代种群
+ * @details 精英直接保留；其余个体由两次3元锦标赛选出父母，
+ *          做均匀交叉后按mutationRate施加高斯变异
+ */
+void NeuroTrainer::evolve() {
+    std::vector<int> order(populationSize);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return fitness[a] > fitness[b]; });
+
+    std::uniform_int_distribution<int> pick(0, populationSize - 1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, config.mutationSigma);
+
+    auto tournament = [&]() {
+        int best = pick(rng);
+        for (int round = 1; round < 3; round++) {
+            int challenger = pick(rng);
+            if (fitness[challenger] > fitness[best]) {
+                best = challenger;
+            }
+        }
+        return best;
+    };
+
+    std::vector<float> next(params.size());
+    int elites = std::min(config.eliteCount, populationSize);
+    for (int g = 0; g < populationSize; g++) {
+        if (g < elites) {
+            for (int p = 0; p < PARAM_COUNT; p++) {
+                next[(size_t)p * populationSize + g] = param(p, order[g]);
+            }
+            continue;
+        }
+        int mother = tournament();
+        int father = tournament();
+        for (int p = 0; p < PARAM_COUNT; p++) {
+            float value = unit(rng) < 0.5f ? param(p, mother) : param(p, father);
+            if (unit(rng) < config.mutationRate) {
+                value += noise(rng);
+            }
+            next[(size_t)p * populationSize + g] = value;
+        }
+    }
+
+    params.swap(next);
+    generation++;
+}
+
+/**
+ * @brief 运行训练主循环
+ * @details 每代输出最佳/平均适应度、代/秒和帧/秒，按需写出适应度曲线和种群存档
+ */
+void NeuroTrainer::run() {
+    std::ofstream curve;
+    if (!config.curvePath.empty()) {
+        curve.open(config.curvePath);
+        curve << "generation,best,mean,generations_per_sec,frames_per_sec\n";
+    }
+
+    auto sessionStart = std::chrono::steady_clock::now();
+    for (int g = 0; g < config.generations; g++) {
+        auto start = std::chrono::steady_clock::now();
+        evaluate();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        float best = *std::max_element(fitness.begin(), fitness.end());
+        float mean = std::accumulate(fitness.begin(), fitness.end(), 0.0f) / populationSize;
+        double gensPerSec = seconds > 0 ? 1.0 / seconds : 0.0;
+        double framesPerSec = seconds > 0 ? simulatedFrames / seconds : 0.0;
+
+        std::cout << "gen " << generation
+                  << "  best " << best
+                  << "  mean " << mean
+                  << "  gen/s " << gensPerSec
+                  << "  frames/s " << framesPerSec << std::endl;
+        if (curve.is_open()) {
+            curve << generation << ',' << best << ',' << mean << ','
+                  << gensPerSec << ',' << framesPerSec << '\n';
+        }
+
+        if (!config.checkpointPath.empty()) {
+            saveCheckpoint(config.checkpointPath);
+        }
+        evolve();
+    }
+
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - sessionStart).count();
+    if (total > 0) {
+        std::cout << "average generations/sec: " << config.generations / total << std::endl;
+    }
+}
+
+/**
+ * @brief 保存种群存档
+ * @details 文件格式（小端）：8字节魔数"DINOPOP1"，uint32版本号、输入/隐藏/输出层大小、
+ *          种群规模、代数，随后是参数主序的float参数和每个个体的float适应度
+ */
+bool NeuroTrainer::saveCheckpoint(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "cannot write checkpoint: " << path << std::endl;
+        return false;
+    }
+
+    uint32_t header[6] = {CHECKPOINT_VERSION, INPUTS, HIDDEN, OUTPUTS, (uint32_t)populationSize, (uint32_t)generation};
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(params.data()), params.size() * sizeof(float));
+    out.write(reinterpret_cast<const char*>(fitness.data()), fitness.size() * sizeof(float));
+    return (bool)out;
+}
+
+bool NeuroTrainer::loadCheckpoint(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[8];
+    uint32_t header[6];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+        !in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        std::cerr << "not a population checkpoint: " << path << std::endl;
+        return false;
+    }
+    if (header[0] != CHECKPOINT_VERSION || header[1] != INPUTS || header[2] != HIDDEN || header[3] != OUTPUTS ||
+        header[4] < 2 || header[4] > (uint32_t)MAX_POPULATION) {
+        std::cerr << "checkpoint topology does not match: " << path << std::endl;
+        return false;
+    }
+
+    // 先核对文件长度，避免按损坏的种群规模分配内存
+    int size = (int)header[4];
+    std::streamoff dataStart = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff expected = dataStart + (std::streamoff)(PARAM_COUNT + 1) * size * (std::streamoff)sizeof(float);
+    if (in.tellg() != expected) {
+        std::cerr << "checkpoint size does not match its header: " << path << std::endl;
+        return false;
+    }
+    in.seekg(dataStart);
+    std::vector<float> loadedParams((size_t)PARAM_COUNT * size);
+    std::vector<float> loadedFitness(size);
+    if (!in.read(reinterpret_cast<char*>(loadedParams.data()), loadedParams.size() * sizeof(float)) ||
+        !in.read(reinterpret_cast<char*>(loadedFitness.data()), loadedFitness.size() * sizeof(float))) {
+        std::cerr << "truncated checkpoint: " << path << std::endl;
+        return false;
+    }
+
+    populationSize = size;
+    generation = (int)header[5];
+    params.swap(loadedParams);
+    fitness.swap(loadedFitness);
+    return true;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file DinoTrainer.h
+ * @brief 神经进化训练器头文件
+ * @details 在进程内以种群为单位演化小型神经网络控制器：共享随机种子的障碍物赛道、
+ *          批量化的种群推理、多线程评估以及二进制种群存档
+ */
+
+#ifndef DINO_TRAINER_H
+#define DINO_TRAINER_H
+
+#include "OptimizedDinoGame.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @enum AgentAction
+ * @brief 控制器每帧输出的动作
+ */
+enum AgentAction {
+    ACTION_STAND = 0,    // 保持站立（下蹲中则起身）
+    ACTION_JUMP = 1,     // 跳跃（与空格键行为一致）
+    ACTION_DUCK = 2      // 下蹲
+};
+
+/**
+ * @brief 把动作作用到恐龙上
+ * @details 把每帧保持的动作换算成按键交给applyPlayerInput，不单独实现跳跃/下蹲规则
+ */
+void applyAgentAction(Dinosaur& dino, int action);
+
+/**
+ * @class TrainingCourse
+ * @brief 由种子决定的障碍物赛道
+ * @details 按DinoGame::update的顺序逐帧生成、移动和清理障碍物，生成记录来自ObstacleSchedule。
+ *          障碍物只取决于帧数和种子，
+ *          与恐龙的动作无关，因此同一代的所有个体可以共享同一条赛道
+ */
+class TrainingCourse {
+private:
+    ObstacleSchedule schedule;        // 与DinoGame相同的障碍物生成计划
+    ObstacleWorld obstacles;          // 当前存活的障碍物
+    int frameCount;                   // 帧计数器，与DinoGame::frameCount含义相同
+    int gameSpeed;                    // 当前游戏速度等级（5-12）
+
+public:
+    explicit TrainingCourse(uint32_t seed);
+
+    /**
+     * @brief 生成并移动障碍物（对应DinoGame::update中碰撞检测之前的部分）
+     */
+    void spawnAndMove();
+
+    /**
+     * @brief 结束当前帧：按分数更新速度等级并推进帧计数
+     */
+    void finishFrame();
+
+    /**
+     * @brief 检测恐龙是否与任一障碍物碰撞
+     */
+    bool collides(const Dinosaur& dino) const;
+
+    /**
+     * @brief 查找恐龙前方最近的障碍物
+     * @return 前方是否有障碍物
+     */
+    bool nextObstacle(const Dinosaur& dino, ObstacleView& view) const;
+
+    int getFrame() const { return frameCount; }
+    int getGameSpeed() const { return gameSpeed; }
+    const ObstacleWorld& getObstacles() const { return obstacles; }
+};
+
+/**
+ * @struct TrainerConfig
+ * @brief 训练参数
+ */
+struct TrainerConfig {
+    int populationSize = 256;        // 种群规模
+    int generations = 50;            // 演化代数
+    int maxFrames = 5000;            // 每条赛道的最大帧数（存活到此即满分）
+    int coursesPerGeneration = 3;    // 每代共享的赛道数量
+    int threads = 0;                 // 评估线程数，0表示使用硬件并发数
+    int eliteCount = 8;              // 直接保留到下一代的精英个体数
+    float mutationRate = 0.1f;       // 每个参数发生变异的概率
+    float mutationSigma = 0.3f;      // 高斯变异的标准差
+    uint32_t seed = 1;               // 基础随机种子
+    std::string checkpointPath;      // 种群存档路径（为空则不存档）
+    std::string curvePath;           // 适应度曲线CSV路径（为空则不输出）
+};
+
+/**
+ * @class NeuroTrainer
+ * @brief 种群神经进化训练器
+ * @details 网络结构为6-8-3的全连接网络（tanh隐藏层，输出取argmax）。
+ *          参数以“参数主序”存放：第p个参数的全部个体连续排列，
+ *          推理时对一批个体逐参数做逐元素乘加，编译器可以直接向量化
+ */
+class NeuroTrainer {
+public:
+    static const int INPUTS = 6;     // 恐龙y、velocityY、前方障碍物距离/高度/类型、gameSpeed
+    static const int HIDDEN = 8;     // 隐藏层神经元数
+    static const int OUTPUTS = 3;    // 站立/跳跃/下蹲
+    static const int PARAM_COUNT = HIDDEN * INPUTS + HIDDEN + OUTPUTS * HIDDEN + OUTPUTS;
+    static const int MAX_POPULATION = 1 << 20;  // 读取存档时接受的最大种群规模
+
+private:
+    TrainerConfig config;
+    int populationSize;              // 实际种群规模（读档后可能与配置不同）
+    int generation;                  // 已完成的代数
+    std::vector<float> params;       // 种群参数，params[p * populationSize + g]
+    std::vector<float> fitness;      // 上一次评估得到的适应度（平均分数）
+    long long simulatedFrames;       // 上一次评估模拟的恐龙帧数（个体数×帧数），用于吞吐量统计
+    std::mt19937 rng;                // 选择/交叉/变异使用的随机数生成器
+
+public:
+    explicit NeuroTrainer(const TrainerConfig& config);
+
+    /**
+     * @brief 运行配置中指定的代数，并输出每代的适应度和吞吐量
+     */
+    void run();
+
+    /**
+     * @brief 评估整个种群（多线程），结果写入fitness
+     */
+    void evaluate();
+
+    /**
+     * @brief 根据适应度产生下一代种群
+     */
+    void evolve();
+
+    /**
+     * @brief 把种群保存为紧凑的二进制存档
+     * @return 是否写入成功
+     */
+    bool saveCheckpoint(const std::string& path) const;
+
+    /**
+     * @brief 从二进制存档恢复种群
+     * @return 是否读取成功（网络结构不匹配时失败）
+     */
+    bool loadCheckpoint(const std::string& path);
+
+    int getGeneration() const { return generation; }
+    int getPopulationSize() const { return populationSize; }
+    const std::vector<float>& getFitness() const { return fitness; }
+    long long getSimulatedFrames() const { return simulatedFrames; }
+
+private:
+    /**
+     * @struct BatchScratch
+     * @brief 每个评估线程的推理缓冲区，在evaluate中按区间大小分配一次，逐帧复用
+     */
+    struct BatchScratch {
+        std::vector<float> inputs;   // INPUTS × count
+        std::vector<float> hidden;   // HIDDEN × count
+        std::vector<float> output;   // OUTPUTS × count
+        std::vector<int> actions;    // count
+    };
+
+    /**
+     * @brief 在一条赛道上评估[begin, end)范围内的个体
+     * @return 本次模拟的恐龙帧数（区间内个体数×推进的帧数）
+     */
+    long long evaluateRange(int begin, int end, uint32_t courseSeed, std::vector<float>& scores,
+                            BatchScratch& scratch) const;
+
+    /**
+     * @brief 批量前向推理
+     * @details 输入取自scratch.inputs（inputs[i * count + k]为第k个个体的第i个输入），
+     *          每个个体选择的动作写入scratch.actions
+     */
+    void forwardBatch(int begin, int count, BatchScratch& scratch) const;
+
+    float param(int p, int g) const { return params[(size_t)p * populationSize + g]; }
+};
+
+#endif // DINO_TRAINER_H
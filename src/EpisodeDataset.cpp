@@ -0,0 +1,499 @@
+/**
+ * @file EpisodeDataset.cpp
+ * @brief 列式对局数据集实现文件
+ * @details 列定义、行采集、后台转置编码写盘和内存映射读取
+ */
+
+#include "EpisodeDataset.h"
+#include <algorithm>
+#include <cfloat>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char FILE_MAGIC[8] = {'D', 'I', 'N', 'O', 'C', 'O', 'L', '1'};
+const char END_MAGIC[8] = {'D', 'I', 'N', 'O', 'C', 'E', 'N', 'D'};
+const char CHUNK_MAGIC[4] = {'D', 'C', 'H', 'K'};
+const uint32_t FORMAT_VERSION = 1;
+
+const size_t NAME_BYTES = 24;                                           // 列名字段长度
+const size_t FILE_HEADER_BYTES = 8 + 4 * 4;                             // 魔数、版本、列数、每块行数、保留
+const size_t SCHEMA_ENTRY_BYTES = NAME_BYTES + 4 + 4;                   // 列名、类型、宽度
+const size_t CHUNK_ENTRY_BYTES = 4 + 4 + 8 + 8;                         // 编码、保留、偏移、字节数
+const size_t CHUNK_HEADER_BYTES = 4 + 4 + CHUNK_ENTRY_BYTES * DATASET_COLUMN_COUNT;
+const size_t FOOTER_TAIL_BYTES = 8 + 8 + 8;                             // 块数、总行数、结束魔数
+
+const ColumnInfo COLUMNS[] = {
+    {"episode", COLUMN_U32, 4, true},
+    {"frame", COLUMN_I32, 4, false},
+    {"dino_y", COLUMN_F32, 4, false},
+    {"dino_velocity_y", COLUMN_F32, 4, false},
+    {"jumping", COLUMN_U8, 1, true},
+    {"ducking", COLUMN_U8, 1, true},
+    {"game_speed", COLUMN_U8, 1, true},
+    {"action", COLUMN_U8, 1, true},
+    {"reward", COLUMN_F32, 4, true},
+    {"obstacle0_dx", COLUMN_F32, 4, false},
+    {"obstacle0_y", COLUMN_F32, 4, true},
+    {"obstacle0_width", COLUMN_F32, 4, true},
+    {"obstacle0_height", COLUMN_F32, 4, true},
+    {"obstacle0_kind", COLUMN_U8, 1, true},
+    {"obstacle1_dx", COLUMN_F32, 4, false},
+    {"obstacle1_y", COLUMN_F32, 4, true},
+    {"obstacle1_width", COLUMN_F32, 4, true},
+    {"obstacle1_height", COLUMN_F32, 4, true},
+    {"obstacle1_kind", COLUMN_U8, 1, true},
+};
+static_assert(sizeof(COLUMNS) / sizeof(COLUMNS[0]) == DATASET_COLUMN_COUNT, "column table out of sync");
+
+static_assert(COL_OBSTACLE1_DX - COL_OBSTACLE0_DX == COL_OBSTACLE1_KIND - COL_OBSTACLE0_KIND &&
+              COL_OBSTACLE1_DX == COL_OBSTACLE0_KIND + 1, "obstacle columns out of sync");
+static_assert(sizeof(DatasetRow) == 44, "staged row layout changed");
+static_assert(DatasetWriter::CHUNK_ROWS % DatasetWriter::SEGMENT_ROWS == 0, "segments must tile a chunk");
+static_assert(FILE_HEADER_BYTES % 8 == 0 && SCHEMA_ENTRY_BYTES % 8 == 0 && CHUNK_HEADER_BYTES % 8 == 0,
+              "headers must keep column data 8-byte aligned");
+
+size_t alignUp(size_t n) { return (n + 7) & ~(size_t)7; }
+
+template <class T>
+void store(std::vector<unsigned char>& out, size_t at, T value) {
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+template <class T>
+T load(const unsigned char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief 把暂存段中的一个字段展开成连续的列
+ * @param field 从一行取出该列的值（类型即列的存储类型）
+ */
+template <class T, class Field>
+void extractColumn(const DatasetRow* rows, int count, unsigned char* out, Field field) {
+    for (int i = 0; i < count; i++) {
+        const T value = field(rows[i]);
+        std::memcpy(out + (size_t)i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+/**
+ * @brief 把一个暂存段展开进块的各列（从第at行开始）
+ */
+void extractSegment(const DatasetRow* rows, int count, std::vector<unsigned char>* columns, int at) {
+    auto out = [&](int c) { return columns[c].data() + (size_t)at * COLUMNS[c].width; };
+    extractColumn<uint32_t>(rows, count, out(COL_EPISODE), [](const DatasetRow& r) { return r.episode; });
+    extractColumn<int32_t>(rows, count, out(COL_FRAME), [](const DatasetRow& r) { return r.frame; });
+    extractColumn<float>(rows, count, out(COL_DINO_Y), [](const DatasetRow& r) { return r.dinoY; });
+    extractColumn<float>(rows, count, out(COL_DINO_VELOCITY_Y), [](const DatasetRow& r) { return r.dinoVelocityY; });
+    extractColumn<uint8_t>(rows, count, out(COL_JUMPING),
+                           [](const DatasetRow& r) { return (uint8_t)((r.flags & DatasetRow::JUMPING) != 0); });
+    extractColumn<uint8_t>(rows, count, out(COL_DUCKING),
+                           [](const DatasetRow& r) { return (uint8_t)((r.flags & DatasetRow::DUCKING) != 0); });
+    extractColumn<uint8_t>(rows, count, out(COL_GAME_SPEED), [](const DatasetRow& r) { return r.gameSpeed; });
+    extractColumn<uint8_t>(rows, count, out(COL_ACTION),
+                           [](const DatasetRow& r) { return (uint8_t)(r.flags >> DatasetRow::ACTION_SHIFT); });
+    extractColumn<float>(rows, count, out(COL_REWARD),
+                         [](const DatasetRow& r) { return (r.flags & DatasetRow::TERMINAL) ? -1.0f : 1.0f; });
+    for (int k = 0; k < DatasetRow::NEAREST_OBSTACLES; k++) {
+        const int base = k * (COL_OBSTACLE1_DX - COL_OBSTACLE0_DX);
+        extractColumn<float>(rows, count, out(COL_OBSTACLE0_DX + base),
+                             [k](const DatasetRow& r) { return r.obstacleDx[k]; });
+        extractColumn<float>(rows, count, out(COL_OBSTACLE0_Y + base),
+                             [k](const DatasetRow& r) { return (float)r.obstacles[k].y; });
+        extractColumn<float>(rows, count, out(COL_OBSTACLE0_WIDTH + base),
+                             [k](const DatasetRow& r) { return (float)r.obstacles[k].width; });
+        extractColumn<float>(rows, count, out(COL_OBSTACLE0_HEIGHT + base),
+                             [k](const DatasetRow& r) { return (float)r.obstacles[k].height; });
+        extractColumn<uint8_t>(rows, count, out(COL_OBSTACLE0_KIND + base),
+                               [k](const DatasetRow& r) { return r.obstacles[k].kind; });
+    }
+}
+
+/**
+ * @brief 游程编码：连续相同的值写成(uint32游程长度, 值)
+ * @tparam T 与列宽相同的无符号整数类型（按位比较，float列的NaN和-0也能原样还原）
+ * @return 编码后的字节数；超过limit时提前放弃并返回limit+1
+ */
+template <class T>
+size_t encodeRle(const unsigned char* data, int rows, unsigned char* out, size_t limit) {
+    size_t used = 0;
+    int i = 0;
+    while (i < rows) {
+        const T value = load<T>(data + (size_t)i * sizeof(T));
+        int run = 1;
+        while (i + run < rows && load<T>(data + (size_t)(i + run) * sizeof(T)) == value) {
+            run++;
+        }
+        if (used + 4 + sizeof(T) > limit) return limit + 1;
+        uint32_t length = (uint32_t)run;
+        std::memcpy(out + used, &length, 4);
+        std::memcpy(out + used + 4, &value, sizeof(T));
+        used += 4 + sizeof(T);
+        i += run;
+    }
+    return used;
+}
+
+}  // namespace
+
+const ColumnInfo& datasetColumn(int column) {
+    return COLUMNS[column];
+}
+
+// ==================== DatasetWriter类实现 ====================
+
+DatasetWriter::DatasetWriter()
+    : cursor(nullptr), limit(nullptr), file(nullptr), rows(0), closing(false), offset(0), storedBytes(0), failed(false) {}
+
+DatasetWriter::~DatasetWriter() {
+    close();
+}
+
+bool DatasetWriter::open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    rows = 0;
+    closing = false;
+    chunkOffsets.clear();
+    offset = 0;
+    storedBytes = 0;
+    failed = false;
+
+    std::vector<unsigned char> header(FILE_HEADER_BYTES + SCHEMA_ENTRY_BYTES * DATASET_COLUMN_COUNT, 0);
+    std::memcpy(header.data(), FILE_MAGIC, 8);
+    store<uint32_t>(header, 8, FORMAT_VERSION);
+    store<uint32_t>(header, 12, DATASET_COLUMN_COUNT);
+    store<uint32_t>(header, 16, CHUNK_ROWS);
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+        size_t at = FILE_HEADER_BYTES + SCHEMA_ENTRY_BYTES * c;
+        std::strncpy(reinterpret_cast<char*>(header.data() + at), COLUMNS[c].name, NAME_BYTES - 1);
+        store<uint32_t>(header, at + NAME_BYTES, (uint32_t)COLUMNS[c].type);
+        store<uint32_t>(header, at + NAME_BYTES + 4, (uint32_t)COLUMNS[c].width);
+    }
+    writeBytes(header.data(), header.size());
+
+    current = takeSegment();
+    cursor = current->staged.data();
+    limit = cursor + SEGMENT_ROWS;
+    worker = std::thread(&DatasetWriter::workerLoop, this);
+    return !failed;
+}
+
+std::unique_ptr<DatasetWriter::Segment> DatasetWriter::takeSegment() {
+    std::unique_ptr<Segment> segment;
+    if (!spare.empty()) {
+        segment = std::move(spare.back());   // 后进先出：最近转置过的段还在缓存中
+        spare.pop_back();
+    } else {
+        segment.reset(new Segment());
+        segment->staged.resize(SEGMENT_ROWS);
+    }
+    segment->rows = 0;
+    return segment;
+}
+
+/**
+ * @brief 把写满的暂存段交给后台线程，换一个空段继续填充
+ * @details 积压达到上限时等待后台线程转置完一段（写盘跟不上时的反压）
+ */
+void DatasetWriter::submit() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return pending.size() < (size_t)MAX_PENDING_SEGMENTS; });
+    current->rows = SEGMENT_ROWS;
+    rows += SEGMENT_ROWS;
+    pending.push_back(std::move(current));
+    current = takeSegment();
+    cursor = current->staged.data();
+    limit = cursor + SEGMENT_ROWS;
+    changed.notify_all();
+}
+
+/**
+ * @details 各段按顺序转置进当前块的列缓冲区，凑满CHUNK_ROWS行时编码写盘；
+ *          关闭时写出不满一块的剩余行
+ */
+void DatasetWriter::workerLoop() {
+    ColumnBuffers columns;                // 当前块转置后的列，各块复用
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+        columns[c].resize((size_t)CHUNK_ROWS * COLUMNS[c].width);
+    }
+    std::vector<unsigned char> encoded;   // 块的编码缓冲区，各块复用
+    int chunkRows = 0;
+    for (;;) {
+        std::unique_ptr<Segment> segment;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this]() { return !pending.empty() || closing; });
+            if (pending.empty()) break;
+            segment = std::move(pending.front());
+            pending.pop_front();
+        }
+        extractSegment(segment->staged.data(), segment->rows, columns.data(), chunkRows);
+        chunkRows += segment->rows;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            spare.push_back(std::move(segment));
+        }
+        changed.notify_all();
+        if (chunkRows == CHUNK_ROWS) {
+            if (!writeChunk(columns, chunkRows, encoded)) {
+                failed = true;
+            }
+            chunkRows = 0;
+        }
+    }
+    if (chunkRows > 0 && !writeChunk(columns, chunkRows, encoded)) {
+        failed = true;
+    }
+}
+
+/**
+ * @brief 逐列选择编码并写出一块
+ * @details 只有允许游程编码的列才尝试编码，且只在不超过原样大小一半时采用；
+ *          逐帧变化的列（帧号、恐龙状态、障碍物距离）总是原样存储，读取时零拷贝
+ */
+bool DatasetWriter::writeChunk(const ColumnBuffers& columns, int chunkRows, std::vector<unsigned char>& encoded) {
+    size_t dataBytes = 0;
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+        dataBytes += alignUp((size_t)chunkRows * COLUMNS[c].width);
+    }
+    encoded.assign(CHUNK_HEADER_BYTES + dataBytes, 0);
+    std::memcpy(encoded.data(), CHUNK_MAGIC, 4);
+    store<uint32_t>(encoded, 4, (uint32_t)chunkRows);
+
+    size_t at = CHUNK_HEADER_BYTES;
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+        const int width = COLUMNS[c].width;
+        const size_t rawBytes = (size_t)chunkRows * width;
+        unsigned char* out = encoded.data() + at;
+        size_t bytes = rawBytes / 2 + 1;   // 不允许游程编码的列直接原样存储
+        if (COLUMNS[c].runLength) {
+            bytes = width == 1 ? encodeRle<uint8_t>(columns[c].data(), chunkRows, out, rawBytes / 2)
+                               : encodeRle<uint32_t>(columns[c].data(), chunkRows, out, rawBytes / 2);
+        }
+        uint32_t codec = CODEC_RLE;
+        if (bytes > rawBytes / 2) {
+            std::memcpy(out, columns[c].data(), rawBytes);
+            bytes = rawBytes;
+            codec = CODEC_RAW;
+        }
+        size_t entry = 8 + CHUNK_ENTRY_BYTES * c;
+        store<uint32_t>(encoded, entry, codec);
+        store<uint64_t>(encoded, entry + 8, offset + at);
+        store<uint64_t>(encoded, entry + 16, bytes);
+        at += alignUp(bytes);
+    }
+
+    chunkOffsets.push_back(offset);
+    storedBytes += (long long)at;
+    return writeBytes(encoded.data(), at);
+}
+
+bool DatasetWriter::writeBytes(const void* data, size_t size) {
+    if (std::fwrite(data, 1, size, file) != size) {
+        failed = true;
+        return false;
+    }
+    offset += size;
+    return true;
+}
+
+bool DatasetWriter::close() {
+    if (!file) return true;
+
+    current->rows = (int)(cursor - current->staged.data());
+    rows += current->rows;
+    if (current->rows > 0) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return pending.size() < (size_t)MAX_PENDING_SEGMENTS; });
+        pending.push_back(std::move(current));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+        changed.notify_all();
+    }
+    worker.join();
+
+    std::vector<unsigned char> footer(chunkOffsets.size() * 8 + FOOTER_TAIL_BYTES);
+    for (size_t i = 0; i < chunkOffsets.size(); i++) {
+        store<uint64_t>(footer, i * 8, chunkOffsets[i]);
+    }
+    size_t tail = chunkOffsets.size() * 8;
+    store<uint64_t>(footer, tail, chunkOffsets.size());
+    store<uint64_t>(footer, tail + 8, (uint64_t)rows);
+    std::memcpy(footer.data() + tail + 16, END_MAGIC, 8);
+    writeBytes(footer.data(), footer.size());
+
+    if (std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+    current.reset();
+    cursor = limit = nullptr;
+    pending.clear();
+    spare.clear();
+    return !failed;
+}
+
+// ==================== DatasetReader类实现 ====================
+
+DatasetReader::DatasetReader() : base(nullptr), size(0), rows(0) {}
+
+DatasetReader::~DatasetReader() {
+    close();
+}
+
+bool DatasetReader::open(const std::string& path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // 映射在文件描述符关闭后仍然有效
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, (size_t)info.st_size, MADV_SEQUENTIAL);
+    base = static_cast<const unsigned char*>(mapped);
+    size = (size_t)info.st_size;
+#else
+    // 没有mmap时读入整个文件，列视图指向这份拷贝
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    fallback.resize((size_t)in.tellg());
+    in.seekg(0);
+    if (fallback.empty() || !in.read(reinterpret_cast<char*>(fallback.data()), fallback.size())) {
+        fallback.clear();
+        return false;
+    }
+    base = fallback.data();
+    size = fallback.size();
+#endif
+    if (!parse()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void DatasetReader::close() {
+#ifndef _WIN32
+    if (base) {
+        munmap(const_cast<unsigned char*>(base), size);
+    }
+#endif
+    base = nullptr;
+    size = 0;
+    fallback.clear();
+    chunks.clear();
+    rows = 0;
+}
+
+/**
+ * @brief 校验文件头和列定义，从文件尾读出块索引并检查每块的列都在文件范围内
+ */
+bool DatasetReader::parse() {
+    const size_t headerBytes = FILE_HEADER_BYTES + SCHEMA_ENTRY_BYTES * DATASET_COLUMN_COUNT;
+    if (size < headerBytes + FOOTER_TAIL_BYTES) return false;
+    if (std::memcmp(base, FILE_MAGIC, 8) != 0 || load<uint32_t>(base + 8) != FORMAT_VERSION ||
+        load<uint32_t>(base + 12) != (uint32_t)DATASET_COLUMN_COUNT) {
+        return false;
+    }
+    const uint32_t chunkRows = load<uint32_t>(base + 16);
+    for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+        const unsigned char* entry = base + FILE_HEADER_BYTES + SCHEMA_ENTRY_BYTES * c;
+        if (std::strncmp(reinterpret_cast<const char*>(entry), COLUMNS[c].name, NAME_BYTES) != 0 ||
+            load<uint32_t>(entry + NAME_BYTES) != (uint32_t)COLUMNS[c].type ||
+            load<uint32_t>(entry + NAME_BYTES + 4) != (uint32_t)COLUMNS[c].width) {
+            return false;
+        }
+    }
+
+    const unsigned char* tail = base + size - FOOTER_TAIL_BYTES;
+    if (std::memcmp(tail + 16, END_MAGIC, 8) != 0) return false;
+    const uint64_t chunkCount = load<uint64_t>(tail);
+    const uint64_t totalRows = load<uint64_t>(tail + 8);
+    if (chunkCount > (size - headerBytes - FOOTER_TAIL_BYTES) / 8) return false;
+    const unsigned char* index = tail - chunkCount * 8;
+
+    long long counted = 0;
+    chunks.resize((size_t)chunkCount);
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const uint64_t at = load<uint64_t>(index + i * 8);
+        if (at < headerBytes || at + CHUNK_HEADER_BYTES > size ||
+            std::memcmp(base + at, CHUNK_MAGIC, 4) != 0) {
+            return false;
+        }
+        ChunkInfo& info = chunks[i];
+        const uint32_t chunkRowCount = load<uint32_t>(base + at + 4);
+        if (chunkRowCount > chunkRows) return false;
+        info.rows = (int)chunkRowCount;
+        for (int c = 0; c < DATASET_COLUMN_COUNT; c++) {
+            const unsigned char* entry = base + at + 8 + CHUNK_ENTRY_BYTES * c;
+            ColumnEntry& column = info.columns[c];
+            column.codec = (uint8_t)load<uint32_t>(entry);
+            column.offset = load<uint64_t>(entry + 8);
+            column.bytes = load<uint64_t>(entry + 16);
+            if (column.offset > size || column.bytes > size - column.offset) return false;
+            const uint64_t rawBytes = (uint64_t)info.rows * COLUMNS[c].width;
+            if (column.codec == CODEC_RAW) {
+                if (column.bytes != rawBytes || column.offset % 8 != 0) return false;
+            } else if (column.codec == CODEC_RLE) {
+                if (column.bytes % (4 + COLUMNS[c].width) != 0) return false;
+            } else {
+                return false;
+            }
+        }
+        counted += info.rows;
+    }
+    rows = counted;
+    return (uint64_t)counted == totalRows;
+}
+
+const void* DatasetReader::rawColumn(size_t chunk, int column) const {
+    const ColumnEntry& entry = chunks[chunk].columns[column];
+    return entry.codec == CODEC_RAW ? base + entry.offset : nullptr;
+}
+
+void DatasetReader::decodeColumn(size_t chunk, int column, void* out) const {
+    const ColumnEntry& entry = chunks[chunk].columns[column];
+    const int width = COLUMNS[column].width;
+    const size_t rowCount = (size_t)chunks[chunk].rows;
+    unsigned char* dst = static_cast<unsigned char*>(out);
+    if (entry.codec == CODEC_RAW) {
+        std::memcpy(dst, base + entry.offset, rowCount * width);
+        return;
+    }
+
+    // 游程总长超出行数的部分（损坏的文件）被截断
+    const unsigned char* p = base + entry.offset;
+    const unsigned char* end = p + entry.bytes;
+    size_t row = 0;
+    for (; p < end && row < rowCount; p += 4 + width) {
+        size_t run = std::min<size_t>(load<uint32_t>(p), rowCount - row);
+        if (width == 1) {
+            std::memset(dst + row, p[4], run);
+        } else {
+            for (size_t i = 0; i < run; i++) {
+                std::memcpy(dst + (row + i) * width, p + 4, width);
+            }
+        }
+        row += run;
+    }
+    std::memset(dst + row * width, 0, (rowCount - row) * width);
+}
@@ -0,0 +1,385 @@
+/**
+ * @file EpisodeDataset.h
+ * @brief 列式对局数据集头文件
+ * @details 逐帧记录恐龙状态、最近的障碍物、速度等级、动作和奖励，按列分块写入二进制文件：
+ *          模拟线程只把整行暂存到行式缓冲区，后台线程负责转置成列、编码和写盘；
+ *          每列定宽，允许游程编码的列每块单独选择编码（原样或游程编码），恐龙状态和障碍物距离等逐帧变化的列总是原样存储；
+ *          读取端内存映射整个文件，原样存储的列直接返回文件内的切片，游程编码的列直接按游程遍历，都不做任何拷贝
+ *
+ * 文件布局（本机字节序，所有列数据按8字节对齐）：
+ *   文件头     "DINOCOL1"、版本、列数、每块行数，随后是每列的名称、类型和宽度
+ *   数据块 *   块头（"DCHK"、行数、每列的编码/偏移/字节数），随后是各列数据
+ *   文件尾     各块块头的偏移、块数、总行数、"DINOCEND"
+ */
+
+#ifndef EPISODE_DATASET_H
+#define EPISODE_DATASET_H
+
+#include "OptimizedDinoGame.h"
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @enum DatasetColumn
+ * @brief 数据集的列
+ */
+enum DatasetColumn {
+    COL_EPISODE = 0,        // 局号（uint32）
+    COL_FRAME,              // 局内帧号（int32）
+    COL_DINO_Y,             // 恐龙y（float）
+    COL_DINO_VELOCITY_Y,    // 恐龙垂直速度（float）
+    COL_JUMPING,            // 是否跳跃中（uint8）
+    COL_DUCKING,            // 是否下蹲中（uint8）
+    COL_GAME_SPEED,         // 速度等级（uint8）
+    COL_ACTION,             // 本帧的输入（uint8，PlayerInput）
+    COL_REWARD,             // 奖励（float，存活1，碰撞-1）
+    COL_OBSTACLE0_DX,       // 最近障碍物左边缘与恐龙右边缘的距离（float）
+    COL_OBSTACLE0_Y,        // 最近障碍物y（float）
+    COL_OBSTACLE0_WIDTH,    // 最近障碍物宽度（float）
+    COL_OBSTACLE0_HEIGHT,   // 最近障碍物高度（float）
+    COL_OBSTACLE0_KIND,     // 最近障碍物种类（uint8，ObstacleKind，没有时为255）
+    COL_OBSTACLE1_DX,       // 第二近的障碍物，含义同上
+    COL_OBSTACLE1_Y,
+    COL_OBSTACLE1_WIDTH,
+    COL_OBSTACLE1_HEIGHT,
+    COL_OBSTACLE1_KIND,
+    DATASET_COLUMN_COUNT
+};
+
+/**
+ * @enum ColumnType
+ * @brief 列的数据类型
+ */
+enum ColumnType {
+    COLUMN_U8 = 0,
+    COLUMN_I32 = 1,
+    COLUMN_U32 = 2,
+    COLUMN_F32 = 3
+};
+
+/**
+ * @enum ColumnCodec
+ * @brief 块内一列的编码
+ */
+enum ColumnCodec {
+    CODEC_RAW = 0,          // 原样存储，可零拷贝读取
+    CODEC_RLE = 1           // 游程编码：(uint32游程长度, 值)序列，用于取值很少变化的列
+};
+
+/**
+ * @struct ColumnInfo
+ * @brief 列的名称、类型、宽度和是否允许游程编码
+ */
+struct ColumnInfo {
+    const char* name;
+    ColumnType type;
+    int width;
+    bool runLength;     // 取值很少变化的列才允许游程编码，其余列总是原样存储以便零拷贝读取
+};
+
+/**
+ * @brief 列定义表，按DatasetColumn索引
+ */
+const ColumnInfo& datasetColumn(int column);
+
+/**
+ * @struct DatasetRow
+ * @brief 一帧的记录在暂存区中的紧凑形式（44字节），后台线程转置时展开成各列
+ * @details 跳跃、下蹲、本帧碰撞和输入合在flags里，展开成jumping/ducking/reward/action列；
+ *          障碍物的y、尺寸和种类直接复制世界中的ObstacleShape，展开时还原为float
+ */
+struct DatasetRow {
+    static const int NEAREST_OBSTACLES = 2;
+    static const uint8_t NO_OBSTACLE = 255;
+    static const uint8_t JUMPING = 1;           // flags：跳跃中
+    static const uint8_t DUCKING = 2;           // flags：下蹲中
+    static const uint8_t TERMINAL = 4;          // flags：本帧碰撞（奖励-1，否则为1）
+    static const int ACTION_SHIFT = 3;          // flags的高位：本帧的输入（PlayerInput）
+
+    uint32_t episode = 0;
+    int32_t frame = 0;
+    float dinoY = 0;
+    float dinoVelocityY = 0;
+    float obstacleDx[NEAREST_OBSTACLES] = {};   // 障碍物左边缘与恐龙右边缘的距离
+    ObstacleShape obstacles[NEAREST_OBSTACLES] = {{0, 0, 0, NO_OBSTACLE, 0}, {0, 0, 0, NO_OBSTACLE, 0}};  // 由世界原样复制
+    uint8_t gameSpeed = 0;
+    uint8_t flags = 0;
+};
+
+/**
+ * @brief 从游戏状态填写一帧的记录（最近的障碍物按右边缘不在恐龙左侧的实体中X最小者计）
+ * @details 只复制本帧已经算好的状态：最近的障碍物由checkCollision求出的ahead直接查出（见ObstacleWorld::nearestAhead）。
+ *          填写row的全部字段，可以直接写入写入器的暂存区（见DatasetWriter::nextRow）。
+ *          每帧都在模拟线程上调用，定义在头文件中以便内联进游戏循环
+ */
+inline void captureDatasetRow(DatasetRow& row, const Dinosaur& dino, const ObstacleWorld& obstacles, const ObstacleAhead& ahead,
+                              int gameSpeed, int action, bool terminal, uint32_t episode, int32_t frame) {
+    row.episode = episode;
+    row.frame = frame;
+    row.dinoY = toFloat(dino.getY());
+    row.dinoVelocityY = toFloat(dino.getVelocityY());
+    row.gameSpeed = (uint8_t)gameSpeed;
+    row.flags = (uint8_t)((dino.getIsJumping() ? DatasetRow::JUMPING : 0) | (dino.getIsDucking() ? DatasetRow::DUCKING : 0) |
+                          (terminal ? DatasetRow::TERMINAL : 0) | (action << DatasetRow::ACTION_SHIFT));
+
+    // 最近的两个障碍物直接由碰撞检测求出的越过数查出，不遍历组件池
+    DinoReal x[DatasetRow::NEAREST_OBSTACLES];
+    const int found = obstacles.nearestAhead(ahead, row.obstacles, x);
+    const DinoReal dinoRight = dino.getX() + dino.getWidth();
+    for (int k = 0; k < found; k++) {
+        row.obstacleDx[k] = toFloat(x[k] - dinoRight);
+    }
+    for (int k = found; k < DatasetRow::NEAREST_OBSTACLES; k++) {
+        row.obstacleDx[k] = 0;
+        row.obstacles[k] = ObstacleShape{0, 0, 0, DatasetRow::NO_OBSTACLE, 0};
+    }
+}
+
+/**
+ * @class DatasetWriter
+ * @brief 流式列式数据集写入器
+ * @details append把整行复制到当前段的行式暂存区（一行44字节，顺序写入一条内存流），
+ *          写满SEGMENT_ROWS行后交给后台线程；后台线程把各段转置进当前块的列缓冲区，
+ *          凑满CHUNK_ROWS行后编码并写盘，模拟线程不接触列缓冲区。
+ *          暂存段很小（176KB）且后进先出地复用，刚被后台线程读过的段仍在缓存中；
+ *          后台积压超过MAX_PENDING_SEGMENTS段时append才会等待
+ */
+class DatasetWriter {
+public:
+    static const int CHUNK_ROWS = 65536;        // 每块行数
+    static const int SEGMENT_ROWS = 4096;       // 每个暂存段的行数
+    static const int MAX_PENDING_SEGMENTS = 32; // 等待转置的暂存段数上限（两块）
+
+private:
+    struct Segment {
+        int rows = 0;
+        std::vector<DatasetRow> staged;         // 行式暂存区（SEGMENT_ROWS行，176KB）
+    };
+    typedef std::array<std::vector<unsigned char>, DATASET_COLUMN_COUNT> ColumnBuffers;
+
+    std::unique_ptr<Segment> current;           // 正在填充的暂存段
+    DatasetRow* cursor;                         // current中下一行的位置
+    DatasetRow* limit;                          // current的末尾
+    std::FILE* file;
+    long long rows;                             // 已交给后台线程的行数
+
+    // 后台写盘线程
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::unique_ptr<Segment>> pending;  // 待转置的暂存段
+    std::vector<std::unique_ptr<Segment>> spare;   // 已转置、可复用的暂存段
+    bool closing;
+
+    // 以下只由后台线程（或close中线程结束之后）访问
+    std::vector<uint64_t> chunkOffsets;
+    uint64_t offset;
+    long long storedBytes;
+    bool failed;
+
+    void submit();
+    void workerLoop();
+    bool writeChunk(const ColumnBuffers& columns, int chunkRows, std::vector<unsigned char>& encoded);
+    bool writeBytes(const void* data, size_t size);
+    std::unique_ptr<Segment> takeSegment();
+
+public:
+    DatasetWriter();
+    ~DatasetWriter();
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    /**
+     * @brief 创建文件并写入文件头，启动后台线程
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief 暂存区中下一行的位置，填写后调用commitRow（省去先构造一行再复制）
+     */
+    DatasetRow& nextRow() { return *cursor; }
+
+    /**
+     * @brief 提交nextRow填写的一行
+     */
+    void commitRow() {
+        if (++cursor == limit) {
+            submit();
+        }
+    }
+
+    /**
+     * @brief 追加一行
+     */
+    void append(const DatasetRow& row) {
+        nextRow() = row;
+        commitRow();
+    }
+
+    /**
+     * @brief 写出最后一块和文件尾，等待后台线程结束
+     * @return 所有写盘操作是否成功
+     */
+    bool close();
+
+    bool isOpen() const { return file != nullptr; }
+    long long getRowCount() const { return current ? rows + (cursor - current->staged.data()) : rows; }
+
+    /**
+     * @brief 写入文件的数据块字节数（close之后有效）
+     */
+    long long getStoredBytes() const { return storedBytes; }
+};
+
+/**
+ * @struct ColumnView
+ * @brief 一块中一列的只读视图
+ */
+template <class T>
+struct ColumnView {
+    const T* data = nullptr;
+    size_t size = 0;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    const T& operator[](size_t i) const { return data[i]; }
+};
+
+/**
+ * @struct ColumnRun
+ * @brief 游程编码列中的一个游程
+ */
+template <class T>
+struct ColumnRun {
+    uint32_t length;
+    T value;
+};
+
+/**
+ * @struct ColumnRuns
+ * @brief 一块中一列游程的只读视图，直接遍历映射内存中的(长度, 值)序列，不解码
+ */
+template <class T>
+struct ColumnRuns {
+    static const size_t STRIDE = 4 + sizeof(T);     // 文件中每个游程的字节数（不对齐，逐个memcpy读取）
+
+    const unsigned char* data = nullptr;
+    size_t count = 0;                               // 游程数
+
+    struct Iterator {
+        const unsigned char* p;
+        ColumnRun<T> operator*() const {
+            ColumnRun<T> run;
+            std::memcpy(&run.length, p, 4);
+            std::memcpy(&run.value, p + 4, sizeof(T));
+            return run;
+        }
+        Iterator& operator++() { p += STRIDE; return *this; }
+        bool operator!=(const Iterator& other) const { return p != other.p; }
+    };
+
+    Iterator begin() const { return Iterator{data}; }
+    Iterator end() const { return Iterator{data + count * STRIDE}; }
+};
+
+/**
+ * @class DatasetReader
+ * @brief 内存映射的数据集读取器
+ * @details 原样存储的列直接返回映射内存中的切片，游程编码的列返回映射内存中的游程序列；
+ *          需要逐行数组时也可以把游程编码的列解码到调用者提供的缓冲区
+ */
+class DatasetReader {
+private:
+    struct ColumnEntry {
+        uint8_t codec;
+        uint64_t offset;
+        uint64_t bytes;
+    };
+    struct ChunkInfo {
+        int rows;
+        std::array<ColumnEntry, DATASET_COLUMN_COUNT> columns;
+    };
+
+    const unsigned char* base;          // 映射的文件内容
+    size_t size;
+    std::vector<unsigned char> fallback;   // 不支持mmap的平台上读入内存的文件内容
+    std::vector<ChunkInfo> chunks;
+    long long rows;
+
+    bool parse();
+
+public:
+    DatasetReader();
+    ~DatasetReader();
+
+    DatasetReader(const DatasetReader&) = delete;
+    DatasetReader& operator=(const DatasetReader&) = delete;
+
+    /**
+     * @brief 映射文件并校验文件头、列定义和文件尾
+     */
+    bool open(const std::string& path);
+    void close();
+
+    size_t getChunkCount() const { return chunks.size(); }
+    int getChunkRows(size_t chunk) const { return chunks[chunk].rows; }
+    long long getRowCount() const { return rows; }
+    ColumnCodec getCodec(size_t chunk, int column) const { return (ColumnCodec)chunks[chunk].columns[column].codec; }
+    uint64_t getStoredBytes(size_t chunk, int column) const { return chunks[chunk].columns[column].bytes; }
+
+    /**
+     * @brief 原样存储的列在映射内存中的起始地址，编码过的列返回nullptr
+     */
+    const void* rawColumn(size_t chunk, int column) const;
+
+    /**
+     * @brief 把一列解码到out（至少行数×列宽字节）
+     */
+    void decodeColumn(size_t chunk, int column, void* out) const;
+
+    /**
+     * @brief 游程编码的列在映射内存中的游程序列，原样存储的列或T的大小与列宽不一致时返回空视图
+     * @details 游程总长由写入端保证等于块的行数（损坏的文件应使用decodeColumn，它会截断超出的部分）
+     */
+    template <class T>
+    ColumnRuns<T> runs(size_t chunk, int column) const {
+        ColumnRuns<T> view;
+        const ColumnEntry& entry = chunks[chunk].columns[column];
+        if (entry.codec != CODEC_RLE || sizeof(T) != (size_t)datasetColumn(column).width) return view;
+        view.data = base + entry.offset;
+        view.count = (size_t)(entry.bytes / ColumnRuns<T>::STRIDE);
+        return view;
+    }
+
+    /**
+     * @brief 取一列：原样存储时零拷贝返回，否则解码到scratch
+     * @details T的大小必须与列宽一致，否则返回空视图
+     */
+    template <class T>
+    ColumnView<T> column(size_t chunk, int column, std::vector<T>& scratch) const {
+        ColumnView<T> view;
+        if (sizeof(T) != (size_t)datasetColumn(column).width) return view;
+        view.size = (size_t)chunks[chunk].rows;
+        if (const void* raw = rawColumn(chunk, column)) {
+            view.data = static_cast<const T*>(raw);
+        } else {
+            scratch.resize(view.size);
+            decodeColumn(chunk, column, scratch.data());
+            view.data = scratch.data();
+        }
+        return view;
+    }
+};
+
+#endif // EPISODE_DATASET_H
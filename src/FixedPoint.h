@@ -0,0 +1,101 @@
+/**
+ * @file FixedPoint.h
+ * @brief 定点数类型与模拟数值类型选择
+ * @details Fixed16为Q16.16定点数，所有运算都是整数运算，结果与编译器、优化选项和SIMD宽度无关。
+ *          DinoReal是游戏模拟状态使用的数值类型：默认float，定义DINO_FIXED_POINT时为Fixed16
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @class Fixed16
+ * @brief Q16.16定点数
+ * @details 可由整数隐式构造（便于书写整数常量），小数常量通过fromDouble在编译期换算；
+ *          不提供到浮点数的隐式转换，避免混合运算悄悄退回浮点
+ */
+class Fixed16 {
+private:
+    int32_t raw;   // 实际值 = raw / 65536
+
+public:
+    static const int FRACTION_BITS = 16;
+    static const int32_t ONE = 1 << FRACTION_BITS;
+
+    constexpr Fixed16() : raw(0) {}
+    constexpr Fixed16(int value) : raw(value * ONE) {}
+
+    static constexpr Fixed16 fromRaw(int32_t value) {
+        Fixed16 result;
+        result.raw = value;
+        return result;
+    }
+
+    /**
+     * @brief 由double换算（四舍五入到最近的1/65536）
+     */
+    static constexpr Fixed16 fromDouble(double value) {
+        return fromRaw((int32_t)(value * ONE + (value >= 0 ? 0.5 : -0.5)));
+    }
+
+    constexpr int32_t getRaw() const { return raw; }
+    constexpr float toFloat() const { return (float)raw / ONE; }
+    constexpr int toInt() const { return raw >> FRACTION_BITS; }   // 向负无穷取整
+
+    constexpr Fixed16 operator-() const { return fromRaw(-raw); }
+    constexpr Fixed16 operator+(Fixed16 other) const { return fromRaw(raw + other.raw); }
+    constexpr Fixed16 operator-(Fixed16 other) const { return fromRaw(raw - other.raw); }
+    constexpr Fixed16 operator*(Fixed16 other) const {
+        return fromRaw((int32_t)(((int64_t)raw * other.raw) >> FRACTION_BITS));
+    }
+    constexpr Fixed16 operator/(Fixed16 other) const {
+        return fromRaw((int32_t)(((int64_t)raw * ONE) / other.raw));
+    }
+
+    Fixed16& operator+=(Fixed16 other) { raw += other.raw; return *this; }
+    Fixed16& operator-=(Fixed16 other) { raw -= other.raw; return *this; }
+    Fixed16& operator*=(Fixed16 other) { return *this = *this * other; }
+    Fixed16& operator/=(Fixed16 other) { return *this = *this / other; }
+
+    constexpr bool operator==(Fixed16 other) const { return raw == other.raw; }
+    constexpr bool operator!=(Fixed16 other) const { return raw != other.raw; }
+    constexpr bool operator<(Fixed16 other) const { return raw < other.raw; }
+    constexpr bool operator<=(Fixed16 other) const { return raw <= other.raw; }
+    constexpr bool operator>(Fixed16 other) const { return raw > other.raw; }
+    constexpr bool operator>=(Fixed16 other) const { return raw >= other.raw; }
+};
+
+/**
+ * @brief 把小数常量换算为模拟数值类型
+ * @details float直接转换（与原先的0.15f字面量逐位相同），Fixed16在编译期四舍五入
+ */
+template <class Num>
+constexpr Num toNumeric(double value) { return (Num)value; }
+
+template <>
+constexpr Fixed16 toNumeric<Fixed16>(double value) { return Fixed16::fromDouble(value); }
+
+inline float toFloat(float value) { return value; }
+inline float toFloat(Fixed16 value) { return value.toFloat(); }
+
+/**
+ * @brief 数值的原始位模式，用于摘要和状态去重
+ */
+inline uint32_t rawBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline uint32_t rawBits(Fixed16 value) { return (uint32_t)value.getRaw(); }
+
+#ifdef DINO_FIXED_POINT
+typedef Fixed16 DinoReal;
+#else
+typedef float DinoReal;
+#endif
+
+#endif // FIXED_POINT_H
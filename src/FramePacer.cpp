@@ -0,0 +1,167 @@
+/**
+ * @file FramePacer.cpp
+ * @brief 帧节奏控制器实现文件
+ * @details 截止时间递推、休眠+自旋的混合等待、自适应余量和帧时间统计
+ */
+
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+const double MIN_SPIN_MARGIN_MS = 0.2;    // 自旋余量下限
+const double MAX_SPIN_MARGIN_MS = 4.0;    // 自旋余量上限
+
+double toMs(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+}  // namespace
+
+FramePacer::FramePacer(PacingPolicy policy) : policy(policy) {
+    setPolicy(policy);
+}
+
+void FramePacer::setPolicy(PacingPolicy newPolicy) {
+    policy = newPolicy;
+    double hz = getTargetHz();
+    period = hz > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz))
+                    : Clock::duration::zero();
+    reset();
+}
+
+double FramePacer::getTargetHz() const {
+    switch (policy) {
+    case PACING_FIXED_60: return 60;
+    case PACING_FIXED_120: return 120;
+    case PACING_UNCAPPED: return 0;
+    default: return 30;  // PACING_FIXED_30和PACING_POWER_SAVING
+    }
+}
+
+void FramePacer::reset() {
+    started = false;
+    spinMarginMs = 1.0;
+    sumMs = 0;
+    sumSquaresMs = 0;
+    workSumMs = 0;
+    markedWorkSumMs = 0;
+    marked = false;
+    stepBacklog = 1;  // 第一帧在呈现之前推进一步
+    stats = FrameStats();
+    stats.spinMarginMs = spinMarginMs;
+}
+
+/**
+ * @brief 等待到下一帧的截止时间
+ * @details 等待分两段：
+ *   - sleep_until到截止时间前spinMarginMs，记录实际醒来时间与请求时间的偏差（休眠超时）
+ *   - 剩余时间以yield自旋，消除操作系统休眠粒度带来的抖动
+ * 余量取休眠超时滑动平均的1.5倍并限制在[0.2, 4]毫秒；省电策略不自旋，直接休眠到截止时间
+ */
+void FramePacer::waitForNextFrame() {
+    Clock::time_point now = Clock::now();
+    if (!started) {
+        started = true;
+        deadline = now + period;
+        lastFrame = now;
+        marked = false;
+        stepBacklog += period > Clock::duration::zero() ? SIMULATION_HZ / getTargetHz() : 0;
+        return;  // 第一帧只建立时间基准
+    }
+    const double workMs = toMs(now - lastFrame);
+
+    if (period > Clock::duration::zero()) {
+        if (now > deadline) {
+            stats.missedDeadlines++;
+            if (now - deadline > period) {
+                deadline = now;  // 落后超过一帧，重新对齐而不是连续追帧
+            }
+        } else if (policy == PACING_POWER_SAVING) {
+            std::this_thread::sleep_until(deadline);
+        } else {
+            auto margin = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(spinMarginMs));
+            Clock::time_point wake = deadline - margin;
+            if (wake > now) {
+                std::this_thread::sleep_until(wake);
+                double overshootMs = std::max(0.0, toMs(Clock::now() - wake));
+                spinMarginMs = 0.9 * spinMarginMs + 0.1 * (overshootMs * 1.5);
+                spinMarginMs = std::min(MAX_SPIN_MARGIN_MS, std::max(MIN_SPIN_MARGIN_MS, spinMarginMs));
+            }
+            while (Clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+        deadline += period;
+    }
+
+    Clock::time_point end = Clock::now();
+    double frameMs = toMs(end - lastFrame);
+    lastFrame = end;
+
+    stats.frames++;
+    sumMs += frameMs;
+    sumSquaresMs += frameMs * frameMs;
+    stats.meanFrameMs = sumMs / stats.frames;
+    stats.jitterMs = std::sqrt(std::max(0.0, sumSquaresMs / stats.frames - stats.meanFrameMs * stats.meanFrameMs));
+    stats.maxFrameMs = std::max(stats.maxFrameMs, frameMs);
+    stats.spinMarginMs = spinMarginMs;
+    stepBacklog += period > Clock::duration::zero() ? SIMULATION_HZ / getTargetHz() : frameMs * SIMULATION_HZ / 1000.0;
+    int bucket = std::min(FrameStats::HISTOGRAM_BUCKETS - 1, (int)frameMs);
+    stats.histogram[bucket]++;
+
+    workSumMs += workMs;
+    stats.meanWorkMs = workSumMs / stats.frames;
+    if (marked) {
+        stats.markedFrames++;
+        markedWorkSumMs += workMs;
+        stats.markedMeanWorkMs = markedWorkSumMs / stats.markedFrames;
+        stats.markedMaxWorkMs = std::max(stats.markedMaxWorkMs, workMs);
+        marked = false;
+    }
+    long long unmarked = stats.frames - stats.markedFrames;
+    stats.unmarkedMeanWorkMs = unmarked > 0 ? (workSumMs - markedWorkSumMs) / unmarked : 0;
+}
+
+int FramePacer::takeSimulationSteps() {
+    int steps = (int)stepBacklog;
+    stepBacklog -= steps;
+    return std::min(steps, MAX_STEPS_PER_FRAME);
+}
+
+void FramePacer::report(std::ostream& out) const {
+    out << "frame pacing: target " << getTargetHz() << " Hz, " << stats.frames << " frames, mean "
+        << stats.meanFrameMs << " ms, jitter " << stats.jitterMs << " ms, max " << stats.maxFrameMs
+        << " ms, missed deadlines " << stats.missedDeadlines << ", spin margin " << stats.spinMarginMs << " ms\n";
+    out << "  work before waiting: mean " << stats.meanWorkMs << " ms\n";
+    if (stats.markedFrames > 0) {
+        out << "  marked frames: " << stats.markedFrames << ", work mean " << stats.markedMeanWorkMs << " ms, max "
+            << stats.markedMaxWorkMs << " ms (other frames work mean " << stats.unmarkedMeanWorkMs << " ms)\n";
+    }
+    for (int i = 0; i < FrameStats::HISTOGRAM_BUCKETS; i++) {
+        if (stats.histogram[i] == 0) continue;
+        out << "  " << i << (i == FrameStats::HISTOGRAM_BUCKETS - 1 ? "+ ms: " : " ms: ") << stats.histogram[i] << '\n';
+    }
+}
+
+bool FramePacer::parsePolicy(const char* name, PacingPolicy& result) {
+    struct Entry { const char* name; PacingPolicy policy; };
+    const Entry entries[] = {
+        {"30", PACING_FIXED_30},
+        {"60", PACING_FIXED_60},
+        {"120", PACING_FIXED_120},
+        {"uncapped", PACING_UNCAPPED},
+        {"powersave", PACING_POWER_SAVING},
+    };
+    for (const Entry& entry : entries) {
+        if (std::strcmp(name, entry.name) == 0) {
+            result = entry.policy;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file FramePacer.h
+ * @brief 帧节奏控制器头文件
+ * @details 基于steady_clock截止时间的帧率控制：先休眠到截止时间前的一小段余量，再自旋等待到截止时间，
+ *          余量根据实测的休眠超时自适应调整；同时统计帧时间直方图和错过的截止时间。
+ *          游戏逻辑始终以SIMULATION_HZ固定步长推进，帧率只影响呈现：每帧按经过的时间累积待推进的步数
+ */
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <array>
+#include <chrono>
+#include <ostream>
+
+/**
+ * @enum PacingPolicy
+ * @brief 帧节奏策略
+ */
+enum PacingPolicy {
+    PACING_FIXED_30,        // 固定30Hz（休眠+自旋）
+    PACING_FIXED_60,        // 固定60Hz
+    PACING_FIXED_120,       // 固定120Hz
+    PACING_UNCAPPED,        // 不限帧率，只做统计
+    PACING_POWER_SAVING     // 30Hz，只休眠不自旋，精度较低但几乎不占CPU
+};
+
+/**
+ * @struct FrameStats
+ * @brief 帧时间统计
+ */
+struct FrameStats {
+    static const int HISTOGRAM_BUCKETS = 64;        // 直方图每格1毫秒，最后一格包含更长的帧
+
+    long long frames = 0;                           // 统计的帧数
+    long long missedDeadlines = 0;                  // 进入等待时已经超过截止时间的帧数
+    double meanFrameMs = 0;                         // 平均帧时间
+    double jitterMs = 0;                            // 帧时间标准差
+    double maxFrameMs = 0;                          // 最长帧时间
+    double spinMarginMs = 0;                        // 当前的自旋余量
+    double meanWorkMs = 0;                          // 平均工作时间（上一次等待结束到本帧进入等待，不含等待）
+    long long markedFrames = 0;                     // 被markFrame标记的帧数
+    double markedMeanWorkMs = 0;                    // 标记帧的平均工作时间
+    double markedMaxWorkMs = 0;                     // 标记帧的最长工作时间
+    double unmarkedMeanWorkMs = 0;                  // 其余帧的平均工作时间
+    std::array<long long, HISTOGRAM_BUCKETS> histogram{};   // 帧时间直方图
+};
+
+/**
+ * @class FramePacer
+ * @brief 帧节奏控制器
+ * @details 每帧结束时调用waitForNextFrame。截止时间按固定周期递推而不是从“现在”开始计时，
+ *          因此本帧的耗时不会让帧率漂移；落后超过一个周期时重新对齐，避免连续追帧
+ */
+class FramePacer {
+public:
+    static const int SIMULATION_HZ = 30;            // 游戏逻辑的固定步频（与原先的delay_ms(30)一致）
+    static const int MAX_STEPS_PER_FRAME = 4;       // 一帧最多追赶的步数，更长的停顿直接丢弃
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    PacingPolicy policy;
+    Clock::duration period;            // 目标帧周期（不限帧率时为0）
+    Clock::time_point deadline;        // 下一帧的截止时间
+    Clock::time_point lastFrame;       // 上一次等待结束的时间
+    bool started;
+    double spinMarginMs;               // 休眠提前量，由休眠超时的滑动平均决定
+    double sumMs, sumSquaresMs;        // 用于计算平均值和标准差
+    double workSumMs;                  // 工作时间之和
+    double markedWorkSumMs;            // 标记帧的工作时间之和
+    bool marked;                       // 当前帧是否被标记
+    double stepBacklog;                // 尚未推进的模拟步数（含小数部分）
+    FrameStats stats;
+
+public:
+    explicit FramePacer(PacingPolicy policy = PACING_FIXED_30);
+
+    void setPolicy(PacingPolicy policy);
+    PacingPolicy getPolicy() const { return policy; }
+
+    /**
+     * @brief 目标帧率（不限帧率时为0）
+     */
+    double getTargetHz() const;
+
+    /**
+     * @brief 清空统计并重新开始计时
+     */
+    void reset();
+
+    /**
+     * @brief 等待到下一帧的截止时间并记录本帧的帧时间
+     */
+    void waitForNextFrame();
+
+    /**
+     * @brief 标记当前帧（如昼夜渐变中的帧），其工作时间另外单独统计，用于和其余帧比较
+     * @details 比较的是进入等待前的工作时间：固定帧率下帧时间总是接近周期，看不出单帧多出的开销
+     */
+    void markFrame() { marked = true; }
+
+    /**
+     * @brief 取出本帧应推进的模拟步数
+     * @details 固定帧率策略每帧累积SIMULATION_HZ / 目标帧率步（30Hz每帧1步，60Hz每2帧1步，120Hz每4帧1步），
+     *          不限帧率时按实测帧时间累积；第一帧固定为1步
+     */
+    int takeSimulationSteps();
+
+    const FrameStats& getStats() const { return stats; }
+
+    /**
+     * @brief 输出帧时间统计和直方图
+     */
+    void report(std::ostream& out) const;
+
+    /**
+     * @brief 解析策略名称（30、60、120、uncapped、powersave）
+     * @return 名称是否有效
+     */
+    static bool parsePolicy(const char* name, PacingPolicy& policy);
+};
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,136 @@
+/**
+ * @file MemoryTracking.cpp
+ * @brief 内存资源层与分配统计实现文件
+ * @details 全局分配计数器、计数内存资源、每局竞技场和分配跟踪器
+ */
+
+#include "MemoryTracking.h"
+#include <algorithm>
+#include <atomic>
+
+// ==================== 全局分配计数 ====================
+
+namespace {
+
+std::atomic<long long> heapAllocations(0);
+std::atomic<long long> heapBytes(0);
+
+AllocationCounts difference(const AllocationCounts& later, const AllocationCounts& earlier) {
+    AllocationCounts result;
+    result.allocations = later.allocations - earlier.allocations;
+    result.bytes = later.bytes - earlier.bytes;
+    return result;
+}
+
+void accumulate(AllocationCounts& total, const AllocationCounts& delta) {
+    total.allocations += delta.allocations;
+    total.bytes += delta.bytes;
+}
+
+}  // namespace
+
+void countHeapAllocation(std::size_t bytes) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    heapBytes.fetch_add((long long)bytes, std::memory_order_relaxed);
+}
+
+AllocationCounts heapAllocationCounts() {
+    AllocationCounts counts;
+    counts.allocations = heapAllocations.load(std::memory_order_relaxed);
+    counts.bytes = heapBytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+// ==================== CountingResource类实现 ====================
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    counts.allocations++;
+    counts.bytes += (long long)bytes;
+    return upstream->allocate(bytes, alignment);
+}
+
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    upstream->deallocate(p, bytes, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+// ==================== EpisodeArena类实现 ====================
+
+EpisodeArena::EpisodeArena(size_t capacity)
+    : buffer(std::max<size_t>(capacity, 64)),
+      overflow(std::pmr::new_delete_resource()),
+      arena(buffer.data(), buffer.size(), &overflow),
+      front(&arena) {}
+
+/**
+ * @brief 整体释放本局的全部分配
+ * @details monotonic_buffer_resource::release只归还溢出块，并把分配位置退回初始缓冲区起点
+ */
+void EpisodeArena::reset() {
+    arena.release();
+    front.resetCounts();
+}
+
+// ==================== AllocationTracker类实现 ====================
+
+void AllocationTracker::closeFrame(const AllocationCounts& now) {
+    AllocationCounts delta = difference(now, frameStart);
+    stats.frames++;
+    stats.lastFrame = delta;
+    accumulate(stats.frameTotal, delta);
+    if (delta.allocations > 0) {
+        stats.framesWithAllocations++;
+    }
+    if (delta.allocations > stats.maxFrame.allocations) {
+        stats.maxFrame = delta;
+    }
+}
+
+void AllocationTracker::beginEpisode() {
+    AllocationCounts now = heapAllocationCounts();
+    if (inFrame) {
+        closeFrame(now);
+        inFrame = false;
+    }
+    if (inEpisode) {
+        // 上一局的统计包含本次重开过程中的分配
+        stats.lastEpisode = difference(now, episodeStart);
+        stats.episodes++;
+    }
+    inEpisode = true;
+    episodeStart = now;
+}
+
+void AllocationTracker::beginFrame() {
+    AllocationCounts now = heapAllocationCounts();
+    if (inFrame) {
+        closeFrame(now);
+    }
+    inFrame = true;
+    frameStart = now;
+}
+
+AllocationStats AllocationTracker::getStats() const {
+    AllocationStats result = stats;
+    if (inEpisode) {
+        result.currentEpisode = difference(heapAllocationCounts(), episodeStart);
+    }
+    return result;
+}
+
+void AllocationTracker::report(std::ostream& out) const {
+    AllocationStats s = getStats();
+    double meanAllocations = s.frames > 0 ? (double)s.frameTotal.allocations / s.frames : 0;
+    double meanBytes = s.frames > 0 ? (double)s.frameTotal.bytes / s.frames : 0;
+    out << "heap allocations: " << s.frames << " frames, " << s.framesWithAllocations
+        << " with allocations, mean " << meanAllocations << " (" << meanBytes << " bytes) per frame, max "
+        << s.maxFrame.allocations << " (" << s.maxFrame.bytes << " bytes)\n"
+        << "  episodes: " << s.episodes << " finished, last " << s.lastEpisode.allocations << " ("
+        << s.lastEpisode.bytes << " bytes), current " << s.currentEpisode.allocations << " ("
+        << s.currentEpisode.bytes << " bytes)\n";
+}
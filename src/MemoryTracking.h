@@ -0,0 +1,149 @@
+/**
+ * @file MemoryTracking.h
+ * @brief 内存资源层与分配统计头文件
+ * @details 每局一个单调竞技场（重开时O(1)整体释放），带计数的std::pmr内存资源，
+ *          以及统计每帧、每局堆分配次数和字节数的跟踪器
+ */
+
+#ifndef MEMORY_TRACKING_H
+#define MEMORY_TRACKING_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <ostream>
+#include <vector>
+
+/**
+ * @struct AllocationCounts
+ * @brief 分配次数和字节数
+ */
+struct AllocationCounts {
+    long long allocations = 0;
+    long long bytes = 0;
+};
+
+/**
+ * @brief 进程启动以来经过全局operator new的分配次数和字节数
+ * @details 链接了AllocationHooks.cpp（dino_alloc_hooks）的程序中全局operator new/delete被替换，
+ *          每次分配以relaxed原子操作计数；其他程序中计数始终为0
+ */
+AllocationCounts heapAllocationCounts();
+
+/**
+ * @brief 记录一次堆分配（由AllocationHooks.cpp中替换的operator new调用）
+ */
+void countHeapAllocation(std::size_t bytes);
+
+/**
+ * @class CountingResource
+ * @brief 统计经过自身的分配的内存资源，实际分配转交给上游资源
+ */
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream;
+    AllocationCounts counts;
+
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    const AllocationCounts& getCounts() const { return counts; }
+    void resetCounts() { counts = AllocationCounts(); }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/**
+ * @class EpisodeArena
+ * @brief 每局一个的单调竞技场
+ * @details 预先分配一块缓冲区，本局的游戏状态容器从中按顺序切分，释放为空操作；
+ *          reset()把竞技场退回到缓冲区起点。缓冲区用完时才向堆申请新的块（计入溢出统计）。
+ *          reset前必须先让所有使用本竞技场的容器放弃内存（见ObstacleWorld::release）
+ */
+class EpisodeArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 64 * 1024;   // 默认初始缓冲区大小（字节）
+
+private:
+    std::vector<unsigned char> buffer;                  // 初始缓冲区（构造时分配一次）
+    CountingResource overflow;                          // 缓冲区用完后向堆申请的块
+    std::pmr::monotonic_buffer_resource arena;          // 单调分配器
+    CountingResource front;                             // 本局经过竞技场的分配
+
+public:
+    explicit EpisodeArena(size_t capacity = DEFAULT_CAPACITY);
+
+    EpisodeArena(const EpisodeArena&) = delete;
+    EpisodeArena& operator=(const EpisodeArena&) = delete;
+
+    /**
+     * @brief 供游戏状态容器使用的内存资源
+     */
+    std::pmr::memory_resource* resource() { return &front; }
+
+    /**
+     * @brief 整体释放本局的全部分配（未溢出时为O(1)）
+     */
+    void reset();
+
+    const AllocationCounts& getEpisodeCounts() const { return front.getCounts(); }
+    const AllocationCounts& getOverflowCounts() const { return overflow.getCounts(); }
+    size_t getCapacity() const { return buffer.size(); }
+};
+
+/**
+ * @struct AllocationStats
+ * @brief 每帧和每局的堆分配统计
+ */
+struct AllocationStats {
+    long long frames = 0;                   // 统计的帧数
+    long long framesWithAllocations = 0;    // 发生过堆分配的帧数
+    long long episodes = 0;                 // 已结束的局数
+    AllocationCounts lastFrame;             // 上一帧
+    AllocationCounts maxFrame;              // 分配次数最多的一帧
+    AllocationCounts frameTotal;            // 所有帧合计
+    AllocationCounts lastEpisode;           // 上一局（含重开本身）
+    AllocationCounts currentEpisode;        // 本局到目前为止
+};
+
+/**
+ * @class AllocationTracker
+ * @brief 按帧、按局切分全局堆分配计数
+ * @details 每帧开始调用beginFrame、每局开始调用beginEpisode，统计两次调用之间heapAllocationCounts的差值。
+ *          计数是进程范围的，适用于游戏这样的单线程主循环
+ */
+class AllocationTracker {
+private:
+    AllocationCounts frameStart;
+    AllocationCounts episodeStart;
+    bool inFrame = false;
+    bool inEpisode = false;
+    AllocationStats stats;
+
+    void closeFrame(const AllocationCounts& now);
+
+public:
+    /**
+     * @brief 结束上一局（如果有）并开始新的一局
+     */
+    void beginEpisode();
+
+    /**
+     * @brief 结束上一帧（如果有）并开始新的一帧
+     */
+    void beginFrame();
+
+    /**
+     * @brief 当前统计（包括尚未结束的一帧和一局）
+     */
+    AllocationStats getStats() const;
+
+    /**
+     * @brief 输出每帧和每局的分配统计
+     */
+    void report(std::ostream& out) const;
+};
+
+#endif // MEMORY_TRACKING_H
@@ -0,0 +1,144 @@
+/**
+ * @file ObstacleSchedule.cpp
+ * @brief 可随机访问的障碍物生成计划实现文件
+ * @details 难度曲线、按块生成与缓存、按帧查询和场上障碍物恢复
+ */
+
+#include "ObstacleSchedule.h"
+#include "ObstacleWorld.h"
+#include <algorithm>
+#include <cmath>
+
+// ==================== DifficultyProfile实现 ====================
+
+int DifficultyProfile::speedAt(int frame) const {
+    return std::min(maxSpeed, startSpeed + frame / framesPerLevel);
+}
+
+int DifficultyProfile::intervalAt(int frame) const {
+    return std::max(minInterval, baseInterval - speedAt(frame) * intervalPerLevel);
+}
+
+// ==================== ObstacleSchedule类实现 ====================
+
+/**
+ * @details 池的最大块按每帧都生成时块数组扩容后的容量（CHUNK_FRAMES×2条记录）设定，
+ *          块数组的每次扩容都能从池中复用；每次向上游申请最多4个块，
+ *          一份计划通常只占十几KB（服务器上同时存在数千份）
+ */
+ObstacleSchedule::ObstacleSchedule(uint64_t seed, const DifficultyProfile& profile)
+    : seed(seed), profile(profile),
+      chunkMemory(std::pmr::pool_options{4, CHUNK_FRAMES * 2 * sizeof(ScheduledSpawn)}),
+      chunks(&chunkMemory) {}
+
+void ObstacleSchedule::reset(uint64_t newSeed) {
+    seed = newSeed;
+    chunks.clear();
+}
+
+/**
+ * @brief 取得第index块
+ * @details 块内逐帧判断生成条件（与generateObstacle的取模规则相同），
+ *          类型和高度取自splitmix64(种子, 帧号)的不同位段
+ */
+const std::pmr::vector<ScheduledSpawn>& ObstacleSchedule::chunk(int index) const {
+    auto found = chunks.find(index);
+    if (found != chunks.end()) {
+        return found->second;
+    }
+
+    if ((int)chunks.size() >= MAX_CACHED_CHUNKS) {
+        // 淘汰离本次查询最远的块
+        auto first = chunks.begin();
+        auto last = std::prev(chunks.end());
+        if (index - first->first > last->first - index) {
+            chunks.erase(first);
+        } else {
+            chunks.erase(last);
+        }
+    }
+
+    std::pmr::vector<ScheduledSpawn>& spawns = chunks[index];
+    spawns.reserve(CHUNK_FRAMES / std::max(1, profile.minInterval) + 1);   // 按最短间隔一次预留，避免逐次扩容
+    int begin = index * CHUNK_FRAMES;
+    for (int frame = begin; frame < begin + CHUNK_FRAMES; frame++) {
+        if (frame % profile.intervalAt(frame) != 0) {
+            continue;
+        }
+        uint64_t bits = splitmix64(seed ^ splitmix64((uint64_t)frame));
+        ScheduledSpawn spawn;
+        spawn.frame = frame;
+        spawn.count = 1;
+        int level = (int)((bits >> 32) % profile.heightLevels);
+        if ((int)(bits % profile.typeRange) >= profile.cactusWeight) {
+            spawn.kind = OBSTACLE_BIRD;
+            spawn.height = profile.birdMinY + level * profile.heightStep;
+        } else {
+            spawn.kind = OBSTACLE_CACTUS;
+            spawn.height = profile.cactusMinHeight + level * profile.heightStep;
+            if (profile.speedAt(frame) >= profile.clusterMinSpeed && ((bits >> 16) & 0xFF) % profile.clusterChance == 0) {
+                spawn.kind = OBSTACLE_CACTUS_CLUSTER;
+                spawn.count = 2 + (int)((bits >> 24) & 1);
+                spawn.height = std::min(spawn.height, profile.clusterMaxHeight);
+            }
+        }
+        spawns.push_back(spawn);
+    }
+    return spawns;
+}
+
+bool ObstacleSchedule::spawnAt(int frame, ScheduledSpawn& spawn) const {
+    if (frame < 0) return false;
+    const std::pmr::vector<ScheduledSpawn>& spawns = chunk(frame / CHUNK_FRAMES);
+    auto it = std::lower_bound(spawns.begin(), spawns.end(), frame,
+        [](const ScheduledSpawn& s, int f) { return s.frame < f; });
+    if (it == spawns.end() || it->frame != frame) {
+        return false;
+    }
+    spawn = *it;
+    return true;
+}
+
+std::vector<ScheduledSpawn> ObstacleSchedule::spawnsBetween(int firstFrame, int lastFrame) const {
+    std::vector<ScheduledSpawn> result;
+    firstFrame = std::max(0, firstFrame);
+    if (lastFrame < firstFrame) return result;
+
+    for (int index = firstFrame / CHUNK_FRAMES; index <= lastFrame / CHUNK_FRAMES; index++) {
+        const std::pmr::vector<ScheduledSpawn>& spawns = chunk(index);
+        auto begin = std::lower_bound(spawns.begin(), spawns.end(), firstFrame,
+            [](const ScheduledSpawn& s, int f) { return s.frame < f; });
+        for (auto it = begin; it != spawns.end() && it->frame <= lastFrame; ++it) {
+            result.push_back(*it);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 恢复第frame帧开始时场上的障碍物
+ * @details 障碍物以最低速度从x=800移到x<-50所需的帧数就是回看窗口，
+ *          窗口内的每个障碍物按游戏顺序（生成、清理、移动）逐帧重放
+ */
+template <class Num>
+void ObstacleSchedule::restore(int frame, BasicObstacleWorld<Num>& world) const {
+    world.clear();
+    if (frame <= 0) return;
+
+    float slowestStep = 5 + profile.startSpeed * 0.15f;
+    int lookback = (int)std::ceil(850 / slowestStep) + 2;
+    std::vector<ScheduledSpawn> spawns = spawnsBetween(frame - lookback, frame - 1);
+    if (spawns.empty()) return;
+
+    size_t next = 0;
+    for (int t = spawns.front().frame; t < frame; t++) {
+        if (next < spawns.size() && spawns[next].frame == t) {
+            world.spawn(spawns[next++]);
+        }
+        world.removeOffscreen();
+        world.update(profile.speedAt(t));
+    }
+}
+
+template void ObstacleSchedule::restore(int frame, BasicObstacleWorld<float>& world) const;
+template void ObstacleSchedule::restore(int frame, BasicObstacleWorld<Fixed16>& world) const;
@@ -0,0 +1,147 @@
+/**
+ * @file ObstacleSchedule.h
+ * @brief 可随机访问的障碍物生成计划头文件
+ * @details 根据种子和难度曲线按块生成障碍物的出生帧、类型和高度，
+ *          支持按帧号二分查找，以及不从第0帧重放就恢复任意帧的障碍物状态
+ */
+
+#ifndef OBSTACLE_SCHEDULE_H
+#define OBSTACLE_SCHEDULE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+template <class Num> class BasicObstacleWorld;
+
+/**
+ * @brief SplitMix64哈希
+ * @details 把(种子, 帧号)映射为互不相关的64位随机数，使每次生成可以独立计算；
+ *          会话服务器也用它从连接的种子派生每一局的种子
+ */
+inline uint64_t splitmix64(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @enum ObstacleKind
+ * @brief 障碍物种类
+ */
+enum ObstacleKind {
+    OBSTACLE_CACTUS = 0,           // 单株仙人掌
+    OBSTACLE_BIRD = 1,             // 飞鸟
+    OBSTACLE_CACTUS_CLUSTER = 2,   // 仙人掌丛（2-3株并排）
+    OBSTACLE_KIND_COUNT = 3
+};
+
+/**
+ * @struct DifficultyProfile
+ * @brief 难度曲线
+ * @details 默认值与DinoGame::generateObstacle和updateGameSpeed中的规则一致
+ */
+struct DifficultyProfile {
+    int startSpeed = 5;           // 初始速度等级
+    int maxSpeed = 12;            // 速度等级上限
+    int framesPerLevel = 200;     // 每多少帧（分）提升一级速度
+    int baseInterval = 80;        // 生成间隔基准帧数
+    int intervalPerLevel = 2;     // 每级速度缩短的间隔帧数
+    int minInterval = 20;         // 最短生成间隔
+    int typeRange = 6;            // 类型随机数范围
+    int cactusWeight = 3;         // 类型随机数小于该值时生成仙人掌
+    int heightLevels = 7;         // 高度档位数
+    int heightStep = 10;          // 每档高度差
+    int cactusMinHeight = 20;     // 仙人掌最小高度
+    int birdMinY = 260;           // 飞鸟最高位置（最小Y坐标）
+    int clusterMinSpeed = 8;      // 达到该速度等级后仙人掌可能成丛出现
+    int clusterChance = 3;        // 满足速度条件时，每clusterChance株仙人掌中约有1株变为仙人掌丛
+    int clusterMaxHeight = 50;    // 仙人掌丛的最大高度（保证可以跳过）
+
+    /**
+     * @brief 第frame帧生成障碍物时使用的速度等级
+     * @details 对应DinoGame中上一帧updateGameSpeed的结果：第frame帧开始时分数为frame
+     */
+    int speedAt(int frame) const;
+
+    /**
+     * @brief 第frame帧的生成间隔
+     */
+    int intervalAt(int frame) const;
+};
+
+/**
+ * @struct ScheduledSpawn
+ * @brief 计划中的一次障碍物生成
+ */
+struct ScheduledSpawn {
+    int frame;          // 出生帧（生成时的frameCount）
+    ObstacleKind kind;  // 障碍物种类
+    int height;         // 仙人掌（丛）高度，或飞鸟的Y坐标
+    int count;          // 仙人掌丛的株数，其他种类为1
+};
+
+/**
+ * @class ObstacleSchedule
+ * @brief 障碍物生成计划
+ * @details 每次生成的类型和高度由(种子, 出生帧)哈希得到，与之前的生成无关，
+ *          因此可以按CHUNK_FRAMES帧为一块按需生成并缓存。按帧查询时先定位块（std::map，O(log n)），
+ *          再在块内二分查找。块缓存从计划自己的池式内存资源分配，
+ *          reset或淘汰释放的块会被之后生成的块复用，长时间运行不再向堆申请内存
+ */
+class ObstacleSchedule {
+public:
+    static const int CHUNK_FRAMES = 4096;     // 每块覆盖的帧数
+    static const int MAX_CACHED_CHUNKS = 64;  // 最多缓存的块数，超出时淘汰离当前查询最远的块
+
+private:
+    uint64_t seed;                                      // 计划种子
+    DifficultyProfile profile;                          // 难度曲线
+    mutable std::pmr::unsynchronized_pool_resource chunkMemory;  // 块缓存使用的池式内存资源
+    mutable std::pmr::map<int, std::pmr::vector<ScheduledSpawn>> chunks;   // 已生成的块（块号 -> 按帧排序的生成记录）
+
+public:
+    explicit ObstacleSchedule(uint64_t seed = 0, const DifficultyProfile& profile = DifficultyProfile());
+
+    /**
+     * @brief 更换种子（清空缓存）
+     */
+    void reset(uint64_t seed);
+
+    /**
+     * @brief 查询第frame帧是否生成障碍物
+     * @param spawn 生成时写入生成记录
+     * @return 该帧是否有障碍物生成
+     */
+    bool spawnAt(int frame, ScheduledSpawn& spawn) const;
+
+    /**
+     * @brief 查询[firstFrame, lastFrame]范围内的所有生成记录（按帧排序）
+     */
+    std::vector<ScheduledSpawn> spawnsBetween(int firstFrame, int lastFrame) const;
+
+    /**
+     * @brief 恢复第frame帧开始时场上的障碍物
+     * @param frame 目标帧（此前的0..frame-1帧已经执行过）
+     * @param world 输出的障碍物世界（会先被清空）
+     * @details 只重放最近一个障碍物生命周期内的生成记录，按游戏顺序（生成、清理、移动）逐帧推进，
+     *          结果与从第0帧连续模拟逐位一致。float和Fixed16两种数值类型的世界都已显式实例化
+     */
+    template <class Num>
+    void restore(int frame, BasicObstacleWorld<Num>& world) const;
+
+    uint64_t getSeed() const { return seed; }
+    const DifficultyProfile& getProfile() const { return profile; }
+    size_t getCachedChunkCount() const { return chunks.size(); }
+
+private:
+    /**
+     * @brief 取得（必要时生成）第index块
+     */
+    const std::pmr::vector<ScheduledSpawn>& chunk(int index) const;
+};
+
+#endif // OBSTACLE_SCHEDULE_H
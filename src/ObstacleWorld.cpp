@@ -0,0 +1,470 @@
+/**
+ * @file ObstacleWorld.cpp
+ * @brief 障碍物实体-组件存储实现文件
+ * @details 各障碍物种类以特征结构体描述（是否有动画、碰撞规则、绘制方式），
+ *          系统函数以种类为模板参数展开，每个组件池的循环内没有任何运行期分派
+ */
+
+#include "ObstacleWorld.h"
+#include "OptimizedDinoGame.h"
+
+namespace {
+
+/**
+ * @struct DinoBox
+ * @brief 每次碰撞检测前取出一次的恐龙包围盒和状态
+ */
+template <class Num>
+struct DinoBox {
+    Num left, right, top, bottom;
+    bool jumping, ducking;
+
+    explicit DinoBox(const BasicDinosaur<Num>& dino)
+        : left(dino.getX()), right(dino.getX() + dino.getWidth()),
+          top(dino.getY()), bottom(dino.getY() + dino.getHeight()),
+          jumping(dino.getIsJumping()), ducking(dino.getIsDucking()) {}
+};
+
+/**
+ * @brief 标准AABB矩形相交测试（与Obstacle::checkCollision一致）
+ * @details 用按位与代替短路求值，组件池循环可以向量化
+ */
+template <class Num>
+inline bool aabbOverlap(const BasicObstaclePool<Num>& p, size_t i, const DinoBox<Num>& dino) {
+    return (dino.right > p.x[i]) &
+           (dino.left < p.x[i] + p.width[i]) &
+           (dino.bottom > p.y[i]) &
+           (dino.top < p.y[i] + p.height[i]);
+}
+
+#ifndef DINO_HEADLESS
+/**
+ * @brief 绘制一株仙人掌（主体加分支装饰，与Cactus::render一致）
+ */
+void drawCactus(float x, float y, float width, float height, color_t color) {
+    setfillcolor(color);
+    solidrect(x, y, x + width, y + height);
+    solidrect(x - 5, y + 10, x, y + 15);
+    solidrect(x + width, y + 10, x + width + 5, y + 15);
+    solidrect(x + 5, y - 5, x + 10, y);
+    solidrect(x + 10, y - 10, x + 15, y - 5);
+}
+#endif
+
+// ==================== 种类特征 ====================
+
+/**
+ * @struct CactusKind
+ * @brief 单株仙人掌：静止图形，标准AABB碰撞
+ */
+struct CactusKind {
+    static const ObstacleKind ID = OBSTACLE_CACTUS;
+    static const bool ANIMATED = false;
+
+    template <class Num>
+    static bool collides(const BasicObstaclePool<Num>& p, size_t i, const DinoBox<Num>& dino) {
+        return aabbOverlap(p, i, dino);
+    }
+
+    template <class Num>
+    static void render(const BasicObstaclePool<Num>& p, size_t i, const DayNightPalette& palette) {
+#ifndef DINO_HEADLESS
+        drawCactus(toFloat(p.x[i]), toFloat(p.y[i]), toFloat(p.width[i]), toFloat(p.height[i]),
+                   palette.color(PALETTE_SPRITE));
+#else
+        (void)p; (void)i; (void)palette;
+#endif
+    }
+};
+
+/**
+ * @struct BirdKind
+ * @brief 飞鸟：翅膀每5帧扇动一次，按高度区分跳跃躲避和下蹲躲避（与Bird类一致）
+ */
+struct BirdKind {
+    static const ObstacleKind ID = OBSTACLE_BIRD;
+    static const bool ANIMATED = true;
+
+    template <class Num>
+    static bool collides(const BasicObstaclePool<Num>& p, size_t i, const DinoBox<Num>& dino) {
+        // 低飞鸟：跳跃中且恐龙底部高于飞鸟顶部；高飞鸟：下蹲中且恐龙底部低于飞鸟下方
+        bool dodged = ((p.rule[i] == RULE_LOW_BIRD) & dino.jumping & (dino.bottom <= p.y[i])) |
+                      ((p.rule[i] == RULE_HIGH_BIRD) & dino.ducking & (dino.bottom <= p.y[i] + Num(20)));
+        return !dodged & aabbOverlap(p, i, dino);
+    }
+
+    template <class Num>
+    static void render(const BasicObstaclePool<Num>& p, size_t i, const DayNightPalette& palette) {
+#ifndef DINO_HEADLESS
+        float x = toFloat(p.x[i]), y = toFloat(p.y[i]);
+        setfillcolor(palette.color(PALETTE_SPRITE));
+        solidrect(x, y, x + toFloat(p.width[i]), y + toFloat(p.height[i]));
+
+        setfillcolor(palette.color(PALETTE_SPRITE_DETAIL));
+        if (p.animationFrame[i] == 0) {
+            solidrect(x + 5, y + 5, x + 15, y + 10);
+        } else {
+            solidrect(x + 15, y + 5, x + 25, y + 10);
+        }
+        solidrect(x + 20, y + 5, x + 22, y + 7);
+#else
+        (void)p; (void)i; (void)palette;
+#endif
+    }
+};
+
+/**
+ * @struct CactusClusterKind
+ * @brief 仙人掌丛：2-3株并排，整体按一个AABB检测碰撞
+ */
+struct CactusClusterKind {
+    static const ObstacleKind ID = OBSTACLE_CACTUS_CLUSTER;
+    static const bool ANIMATED = false;
+    static const int PART_WIDTH = 20;     // 每株宽度
+    static const int PART_SPACING = 5;    // 相邻两株的间隙
+
+    template <class Num>
+    static bool collides(const BasicObstaclePool<Num>& p, size_t i, const DinoBox<Num>& dino) {
+        return aabbOverlap(p, i, dino);
+    }
+
+    template <class Num>
+    static void render(const BasicObstaclePool<Num>& p, size_t i, const DayNightPalette& palette) {
+#ifndef DINO_HEADLESS
+        for (int part = 0; part < p.count[i]; part++) {
+            drawCactus(toFloat(p.x[i]) + part * (PART_WIDTH + PART_SPACING), toFloat(p.y[i]), PART_WIDTH, toFloat(p.height[i]),
+                       palette.color(PALETTE_SPRITE));
+        }
+#else
+        (void)p; (void)i; (void)palette;
+#endif
+    }
+};
+
+/**
+ * @brief 编译期种类列表，each()对每个种类调用一次f(Kind{})
+ */
+template <class... Kinds>
+struct KindList {
+    template <class Func>
+    static void each(Func&& f) { (f(Kinds{}), ...); }
+
+    template <class Pred>
+    static bool any(Pred&& pred) { return (pred(Kinds{}) || ...); }
+};
+
+using AllKinds = KindList<CactusKind, BirdKind, CactusClusterKind>;
+
+// ==================== 系统 ====================
+
+/**
+ * @brief 移动系统与动画系统
+ * @details 实际速度 = speed + gameSpeed * 0.15，与Obstacle::update的运算顺序相同
+ *          （float时0.15就是原来的0.15f字面量）；只有ANIMATED的种类才会生成动画循环
+ */
+template <class Kind, class Num>
+void moveSystem(BasicObstaclePool<Num>& p, Num gameSpeed) {
+    size_t n = p.size();
+    Num* x = p.x.data();
+    const Num* speed = p.speed.data();
+    const Num step = gameSpeed * toNumeric<Num>(0.15);
+    for (size_t i = 0; i < n; i++) {
+        x[i] -= (speed[i] + step);
+    }
+
+    if constexpr (Kind::ANIMATED) {
+        // 计数器只保存模5的相位，每5帧切换一次动画帧（与Bird::update的节奏相同）
+        int* counter = p.animationCounter.data();
+        int* frame = p.animationFrame.data();
+        for (size_t i = 0; i < n; i++) {
+            int next = counter[i] + 1;
+            int wrap = next == 5;
+            counter[i] = wrap ? 0 : next;
+            frame[i] ^= wrap;
+        }
+    }
+}
+
+/**
+ * @brief 跳过组件池开头已经被越过的实体（右边缘在恐龙左侧），返回第一个未被越过的下标
+ * @details 实体按出生顺序排列且同速左移，被越过的总是开头的一两个
+ */
+template <class Num>
+size_t firstAhead(const BasicObstaclePool<Num>& p, const DinoBox<Num>& dino) {
+    size_t i = 0;
+    while (i < p.size() && p.x[i] + p.width[i] < dino.left) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @details 从first开始检测：first之前的实体右边缘在恐龙左侧，AABB不可能相交
+ */
+template <class Kind, class Num>
+bool collisionSystem(const BasicObstaclePool<Num>& p, size_t first, const DinoBox<Num>& dino) {
+    bool hit = false;
+    for (size_t i = first; i < p.size(); i++) {
+        hit |= Kind::collides(p, i, dino);
+    }
+    return hit;
+}
+
+template <class Kind, class Num>
+void renderSystem(const BasicObstaclePool<Num>& p, const DayNightPalette& palette) {
+    for (size_t i = 0; i < p.size(); i++) {
+        Kind::render(p, i, palette);
+    }
+}
+
+template <class Vector>
+void eraseRange(Vector& values, size_t first, size_t last) {
+    values.erase(values.begin() + first, values.begin() + last);
+}
+
+/**
+ * @brief 清空组件数组并归还内存（与同一资源上的空数组交换，旧缓冲区随临时对象释放）
+ */
+template <class Vector>
+void releaseVector(Vector& values) {
+    Vector(values.get_allocator()).swap(values);
+}
+
+/**
+ * @brief 稳定地压缩组件池，移除X<-50的实体
+ * @return 移除的实体数
+ */
+template <class Num>
+size_t removeOffscreenSystem(BasicObstaclePool<Num>& p) {
+    size_t first = 0;
+    while (first < p.size() && p.x[first] >= Num(-50)) {
+        first++;
+    }
+    if (first == p.size()) {
+        return 0;  // 绝大多数帧没有实体需要移除
+    }
+
+    size_t last = first;
+    while (last < p.size() && p.x[last] < Num(-50)) {
+        last++;
+    }
+    bool contiguous = true;
+    for (size_t i = last; i < p.size(); i++) {
+        contiguous = contiguous && p.x[i] >= Num(-50);
+    }
+    if (contiguous) {
+        // 实体按出生顺序排列且同速移动，移出屏幕的总是连续的一段，按段整体搬移
+        eraseRange(p.x, first, last);
+        eraseRange(p.y, first, last);
+        eraseRange(p.width, first, last);
+        eraseRange(p.height, first, last);
+        eraseRange(p.speed, first, last);
+        eraseRange(p.animationCounter, first, last);
+        eraseRange(p.animationFrame, first, last);
+        eraseRange(p.rule, first, last);
+        eraseRange(p.count, first, last);
+        return last - first;
+    }
+
+    size_t kept = first;
+    for (size_t i = first; i < p.size(); i++) {
+        if (p.x[i] < Num(-50)) continue;
+        if (kept != i) {
+            p.x[kept] = p.x[i];
+            p.y[kept] = p.y[i];
+            p.width[kept] = p.width[i];
+            p.height[kept] = p.height[i];
+            p.speed[kept] = p.speed[i];
+            p.animationCounter[kept] = p.animationCounter[i];
+            p.animationFrame[kept] = p.animationFrame[i];
+            p.rule[kept] = p.rule[i];
+            p.count[kept] = p.count[i];
+        }
+        kept++;
+    }
+    size_t removed = p.size() - kept;
+    p.x.resize(kept);
+    p.y.resize(kept);
+    p.width.resize(kept);
+    p.height.resize(kept);
+    p.speed.resize(kept);
+    p.animationCounter.resize(kept);
+    p.animationFrame.resize(kept);
+    p.rule.resize(kept);
+    p.count.resize(kept);
+    return removed;
+}
+
+}  // namespace
+
+// ==================== ObstaclePool实现 ====================
+
+template <class Num>
+BasicObstaclePool<Num>::BasicObstaclePool(std::pmr::memory_resource* resource)
+    : x(resource), y(resource), width(resource), height(resource), speed(resource),
+      animationCounter(resource), animationFrame(resource), rule(resource), count(resource) {}
+
+template <class Num>
+void BasicObstaclePool<Num>::clear() {
+    x.clear();
+    y.clear();
+    width.clear();
+    height.clear();
+    speed.clear();
+    animationCounter.clear();
+    animationFrame.clear();
+    rule.clear();
+    count.clear();
+}
+
+template <class Num>
+void BasicObstaclePool<Num>::release() {
+    releaseVector(x);
+    releaseVector(y);
+    releaseVector(width);
+    releaseVector(height);
+    releaseVector(speed);
+    releaseVector(animationCounter);
+    releaseVector(animationFrame);
+    releaseVector(rule);
+    releaseVector(count);
+}
+
+template <class Num>
+void BasicObstaclePool<Num>::push(Num px, Num py, Num w, Num h, CollisionRule collisionRule, int parts) {
+    x.push_back(px);
+    y.push_back(py);
+    width.push_back(w);
+    height.push_back(h);
+    speed.push_back(5);  // 基础速度5像素/帧
+    animationCounter.push_back(0);
+    animationFrame.push_back(0);
+    rule.push_back((unsigned char)collisionRule);
+    count.push_back((unsigned char)parts);
+}
+
+// ==================== ObstacleWorld实现 ====================
+
+template <class Num>
+BasicObstacleWorld<Num>::BasicObstacleWorld(std::pmr::memory_resource* resource)
+    : pools{{BasicObstaclePool<Num>(resource), BasicObstaclePool<Num>(resource), BasicObstaclePool<Num>(resource)}},
+      shapes(resource) {
+    static_assert(OBSTACLE_KIND_COUNT == 3, "每个种类需要一个以resource构造的组件池");
+}
+
+/**
+ * @brief 按生成记录创建实体
+ * @details 尺寸与原Cactus(20×高度)、Bird(30×20)一致；飞鸟Y≥310为低飞鸟，否则为高飞鸟
+ */
+template <class Num>
+void BasicObstacleWorld<Num>::spawn(const ScheduledSpawn& spawn) {
+    switch (spawn.kind) {
+    case OBSTACLE_BIRD:
+        pools[OBSTACLE_BIRD].push(800, spawn.height, 30, 20,
+                                  spawn.height >= 310 ? RULE_LOW_BIRD : RULE_HIGH_BIRD, 1);
+        shapes.push_back(ObstacleShape{(int16_t)spawn.height, 30, 20, OBSTACLE_BIRD, 0});
+        break;
+    case OBSTACLE_CACTUS_CLUSTER: {
+        int width = spawn.count * CactusClusterKind::PART_WIDTH + (spawn.count - 1) * CactusClusterKind::PART_SPACING;
+        pools[OBSTACLE_CACTUS_CLUSTER].push(800, 340 - spawn.height, width, spawn.height, RULE_AABB, spawn.count);
+        shapes.push_back(ObstacleShape{(int16_t)(340 - spawn.height), (int16_t)width, (int16_t)spawn.height,
+                                       OBSTACLE_CACTUS_CLUSTER, 0});
+        break;
+    }
+    default:
+        pools[OBSTACLE_CACTUS].push(800, 340 - spawn.height, 20, spawn.height, RULE_AABB, 1);
+        shapes.push_back(ObstacleShape{(int16_t)(340 - spawn.height), 20, (int16_t)spawn.height, OBSTACLE_CACTUS, 0});
+        break;
+    }
+}
+
+template <class Num>
+void BasicObstacleWorld<Num>::update(Num gameSpeed) {
+    AllKinds::each([&](auto kind) {
+        using Kind = decltype(kind);
+        moveSystem<Kind>(pools[Kind::ID], gameSpeed);
+    });
+}
+
+template <class Num>
+void BasicObstacleWorld<Num>::removeOffscreen() {
+    size_t removed = 0;
+    for (auto& p : pools) {
+        removed += removeOffscreenSystem(p);
+    }
+    if (removed > 0) {
+        // 移出屏幕的总是出生最早的实体
+        eraseRange(shapes, 0, removed);
+    }
+}
+
+template <class Num>
+bool BasicObstacleWorld<Num>::checkCollision(const BasicDinosaur<Num>& dino) const {
+    ObstacleAhead ahead;
+    return checkCollision(dino, ahead);
+}
+
+template <class Num>
+bool BasicObstacleWorld<Num>::checkCollision(const BasicDinosaur<Num>& dino, ObstacleAhead& ahead) const {
+    DinoBox<Num> box(dino);
+    bool hit = false;
+    AllKinds::each([&](auto kind) {
+        using Kind = decltype(kind);
+        const BasicObstaclePool<Num>& p = pools[Kind::ID];
+        size_t first = firstAhead(p, box);
+        ahead[Kind::ID] = (uint32_t)first;
+        hit = hit || collisionSystem<Kind>(p, first, box);
+    });
+    return hit;
+}
+
+template <class Num>
+void BasicObstacleWorld<Num>::render(const DayNightPalette& palette) const {
+    AllKinds::each([&](auto kind) {
+        using Kind = decltype(kind);
+        renderSystem<Kind>(pools[Kind::ID], palette);
+    });
+}
+
+template <class Num>
+bool BasicObstacleWorld<Num>::nearestAhead(float minX, ObstacleView& view) const {
+    bool found = false;
+    forEach([&](const ObstacleView& candidate) {
+        if (candidate.x + candidate.width < minX) return;
+        if (!found || candidate.x < view.x) {
+            view = candidate;
+            found = true;
+        }
+    });
+    return found;
+}
+
+template <class Num>
+void BasicObstacleWorld<Num>::clear() {
+    for (auto& p : pools) {
+        p.clear();
+    }
+    shapes.clear();
+}
+
+template <class Num>
+void BasicObstacleWorld<Num>::release() {
+    for (auto& p : pools) {
+        p.release();
+    }
+    releaseVector(shapes);
+}
+
+template <class Num>
+size_t BasicObstacleWorld<Num>::size() const {
+    size_t total = 0;
+    for (const auto& p : pools) {
+        total += p.size();
+    }
+    return total;
+}
+
+template struct BasicObstaclePool<float>;
+template struct BasicObstaclePool<Fixed16>;
+template class BasicObstacleWorld<float>;
+template class BasicObstacleWorld<Fixed16>;
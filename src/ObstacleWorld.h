@@ -0,0 +1,206 @@
+/**
+ * @file ObstacleWorld.h
+ * @brief 障碍物实体-组件存储头文件
+ * @details 以轻量ECS的方式存放所有障碍物：每个种类一个组件池，组件按数组连续存放；
+ *          移动、动画、碰撞和渲染系统在ObstacleWorld.cpp中按种类模板化生成，
+ *          每帧的分派在编译期完成，不再经过虚函数。
+ *          位置和尺寸组件的数值类型是模板参数，游戏使用DinoReal（见FixedPoint.h）
+ */
+
+#ifndef OBSTACLE_WORLD_H
+#define OBSTACLE_WORLD_H
+
+#include "FixedPoint.h"
+#include "ObstacleSchedule.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+template <class Num> class BasicDinosaur;
+class DayNightPalette;
+
+/**
+ * @enum CollisionRule
+ * @brief 碰撞规则组件的取值
+ */
+enum CollisionRule {
+    RULE_AABB = 0,          // 标准AABB矩形碰撞
+    RULE_LOW_BIRD = 1,      // 低飞鸟：跳跃越过顶部时不碰撞
+    RULE_HIGH_BIRD = 2      // 高飞鸟：下蹲低于下沿时不碰撞
+};
+
+/**
+ * @struct BasicObstaclePool
+ * @brief 单个种类障碍物的组件池
+ * @details 下标相同的元素属于同一个实体，所有组件数组长度始终一致；
+ *          组件数组从构造时给定的内存资源分配（游戏使用每局的竞技场，见EpisodeArena）
+ */
+template <class Num>
+struct BasicObstaclePool {
+    std::pmr::vector<Num> x, y;              // 位置组件
+    std::pmr::vector<Num> width, height;     // 尺寸组件
+    std::pmr::vector<Num> speed;             // 速度组件（基础速度，实际速度再加上gameSpeed * 0.15）
+    std::pmr::vector<int> animationCounter;  // 动画组件：帧计数（模5的相位）
+    std::pmr::vector<int> animationFrame;    // 动画组件：当前动画帧（飞鸟翅膀位置）
+    std::pmr::vector<unsigned char> rule;    // 碰撞规则组件
+    std::pmr::vector<unsigned char> count;   // 仙人掌丛的株数
+
+    explicit BasicObstaclePool(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    size_t size() const { return x.size(); }
+    void clear();
+
+    /**
+     * @brief 清空并把组件数组的内存归还给内存资源
+     */
+    void release();
+    void push(Num px, Num py, Num w, Num h, CollisionRule collisionRule, int parts);
+};
+
+typedef BasicObstaclePool<DinoReal> ObstaclePool;
+
+/**
+ * @brief 每个组件池开头已被恐龙越过（右边缘在恐龙左侧）的实体数
+ * @details 由checkCollision顺带求出，配合BasicObstacleWorld::nearestAhead取恐龙前方最近的实体
+ */
+typedef std::array<uint32_t, OBSTACLE_KIND_COUNT> ObstacleAhead;
+
+/**
+ * @struct ObstacleShape
+ * @brief 实体出生时确定、之后不再改变的属性（都是整数）
+ * @details 世界按出生顺序另存一份，取最近的实体时整条复制，不必逐个组件读取和转换
+ */
+struct ObstacleShape {
+    int16_t y = 0, width = 0, height = 0;
+    uint8_t kind = 0;
+    uint8_t reserved = 0;
+};
+
+/**
+ * @struct ObstacleView
+ * @brief 只读的障碍物快照，供训练器、分析工具查询
+ * @details 坐标统一换算为float，与世界使用的数值类型无关
+ */
+struct ObstacleView {
+    ObstacleKind kind;
+    float x, y, width, height;
+};
+
+/**
+ * @class BasicObstacleWorld
+ * @brief 障碍物世界
+ * @details 替代原先的std::vector<std::unique_ptr<Obstacle>>，每帧的调用顺序与原实现一致：
+ *          spawn（生成）-> removeOffscreen（清理）-> update（移动）-> checkCollision（碰撞检测）。
+ *          成员函数在ObstacleWorld.cpp中实现，并对float和Fixed16显式实例化
+ */
+template <class Num>
+class BasicObstacleWorld {
+private:
+    std::array<BasicObstaclePool<Num>, OBSTACLE_KIND_COUNT> pools;   // 按ObstacleKind索引的组件池
+    std::pmr::vector<ObstacleShape> shapes;                          // 所有实体按出生顺序（即X升序）的不变属性
+
+public:
+    /**
+     * @param resource 组件数组使用的内存资源
+     */
+    explicit BasicObstacleWorld(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief 按生成记录在x=800处创建一个实体
+     */
+    void spawn(const ScheduledSpawn& spawn);
+
+    /**
+     * @brief 移动系统与动画系统（每帧调用）
+     * @param gameSpeed 游戏速度等级
+     */
+    void update(Num gameSpeed);
+
+    /**
+     * @brief 清理移出屏幕左侧（X<-50）的实体
+     */
+    void removeOffscreen();
+
+    /**
+     * @brief 碰撞系统：检测恐龙是否与任一实体碰撞
+     * @details 每个组件池先跳过已经被越过的实体（它们不可能与恐龙相交），只检测其后的实体
+     */
+    bool checkCollision(const BasicDinosaur<Num>& dino) const;
+
+    /**
+     * @brief 同checkCollision，并把每个组件池跳过的实体数写入ahead
+     */
+    bool checkCollision(const BasicDinosaur<Num>& dino, ObstacleAhead& ahead) const;
+
+    /**
+     * @brief 渲染系统（颜色取自调色板的当前行）
+     */
+    void render(const DayNightPalette& palette) const;
+
+    /**
+     * @brief 恐龙前方最近的Count个实体，由近及远
+     * @details 所有实体都在同一位置出生并同速左移，X顺序就是出生顺序；出生间隔远大于宽度差，
+     *          越过的顺序也是出生顺序。因此越过的实体数是ahead之和，shapes中其后的几项就是所求的实体，
+     *          组件池中的下标是该池越过的实体数加上它之前同种类的实体数。只做几次查表，不遍历组件池
+     * @param ahead 本帧checkCollision求出的各池越过的实体数
+     * @param shape 输出各实体的不变属性
+     * @param x 输出各实体当前的X
+     * @return 找到的个数（前方实体不足Count个时小于Count，其余输出不变）
+     */
+    template <int Count>
+    int nearestAhead(const ObstacleAhead& ahead, ObstacleShape (&shape)[Count], Num (&x)[Count]) const {
+        size_t position = 0;
+        for (uint32_t passed : ahead) {
+            position += passed;
+        }
+        int found = 0;
+        for (; found < Count && position + found < shapes.size(); found++) {
+            shape[found] = shapes[position + found];
+            const uint8_t kind = shape[found].kind;
+            size_t index = ahead[kind];
+            for (int j = 0; j < found; j++) {
+                index += shape[j].kind == kind;
+            }
+            x[found] = pools[kind].x[index];
+        }
+        return found;
+    }
+
+    /**
+     * @brief 查找右边缘不在minX左侧的实体中最靠左的一个
+     * @return 是否找到
+     */
+    bool nearestAhead(float minX, ObstacleView& view) const;
+
+    void clear();
+
+    /**
+     * @brief 清空并归还全部内存，在重置所用的竞技场之前调用
+     */
+    void release();
+
+    size_t size() const;
+
+    const BasicObstaclePool<Num>& pool(ObstacleKind kind) const { return pools[kind]; }
+
+    /**
+     * @brief 依次访问所有实体
+     * @param visit 可调用对象，参数为const ObstacleView&
+     */
+    template <class Visitor>
+    void forEach(Visitor&& visit) const {
+        for (int kind = 0; kind < OBSTACLE_KIND_COUNT; kind++) {
+            const BasicObstaclePool<Num>& p = pools[kind];
+            for (size_t i = 0; i < p.size(); i++) {
+                visit(ObstacleView{(ObstacleKind)kind, toFloat(p.x[i]), toFloat(p.y[i]),
+                                   toFloat(p.width[i]), toFloat(p.height[i])});
+            }
+        }
+    }
+};
+
+typedef BasicObstacleWorld<DinoReal> ObstacleWorld;
+
+#endif // OBSTACLE_WORLD_H
@@ -5,11 +5,16 @@
  */
 
 #include "OptimizedDinoGame.h"
+#include "EpisodeDataset.h"
+#include "Telemetry.h"
+#include "AudioMixer.h"
+#ifndef DINO_HEADLESS
 #include <conio.h>
+#endif
 #include <algorithm>
 #include <ctime>
+#include <cstdio>
 #include <cstdlib>
-#include <string>
 
 // ==================== Dinosaur类实现 ====================
 
@@ -17,15 +22,18 @@
  * @brief Dinosaur类构造函数
  * @details 初始化恐龙位置、速度和状态标志
  */
-Dinosaur::Dinosaur() : x(50), y(340 - 60), velocityY(0), isJumping(false), isDucking(false), groundLevel(340) {}
+template <class Num>
+BasicDinosaur<Num>::BasicDinosaur() : x(50), y(340 - 60), velocityY(0), isJumping(false), isDucking(false), groundLevel(340) {}
 
-Dinosaur::~Dinosaur() {}
+template <class Num>
+BasicDinosaur<Num>::~BasicDinosaur() {}
 
 /**
  * @brief 执行跳跃动作
  * @details 只有在非跳跃且非下蹲状态下才能跳跃。设置isJumping=true并赋予初始向上速度-15
  */
-void Dinosaur::jump() {
+template <class Num>
+void BasicDinosaur<Num>::jump() {
     if (!isJumping && !isDucking) {
         isJumping = true;
         velocityY = -15;  // 负数表示向上，初始跳跃速度
@@ -36,7 +44,8 @@ void Dinosaur::jump() {
  * @brief 执行下蹲动作
  * @details 只有在非跳跃状态下才能下蹲。设置isDucking=true并调整y坐标使恐龙高度变为30
  */
-void Dinosaur::duck() {
+template <class Num>
+void BasicDinosaur<Num>::duck() {
     if (!isJumping) {
         isDucking = true;
         y = groundLevel - DINO_HEIGHT_DUCK;  // 下蹲后高度变为30像素
@@ -47,7 +56,8 @@ void Dinosaur::duck() {
  * @brief 恢复站立状态
  * @details 取消下蹲标志并恢复正常高度60
  */
-void Dinosaur::stand() {
+template <class Num>
+void BasicDinosaur<Num>::stand() {
     isDucking = false;
     y = groundLevel - DINO_HEIGHT;  // 恢复正常高度60像素
 }
@@ -65,7 +75,8 @@ void Dinosaur::stand() {
  *   - 当y坐标≥地面位置时，恐龙着陆
  *   - 重置isJumping标志和velocityY
  */
-void Dinosaur::update() {
+template <class Num>
+void BasicDinosaur<Num>::update() {
     if (isJumping) {
         y += velocityY;          // 根据垂直速度更新位置
         velocityY += 1;          // 每帧速度增加1，模拟重力加速度
@@ -83,35 +94,75 @@ void Dinosaur::update() {
  * @brief 渲染恐龙到屏幕
  * @details 根据当前状态（站立/下蹲/跳跃）绘制不同形态的恐龙图形，包括身体、眼睛和腿部装饰
  */
-void Dinosaur::render() {
-    setfillcolor(BLACK);
-    solidrect(x, y, x + getWidth(), y + getHeight());
+template <class Num>
+void BasicDinosaur<Num>::render(const DayNightPalette& palette) {
+#ifndef DINO_HEADLESS
+    float x = toFloat(this->x), y = toFloat(this->y);
+    float width = toFloat(getWidth()), height = toFloat(getHeight());
+    setfillcolor(palette.color(PALETTE_SPRITE));
+    solidrect(x, y, x + width, y + height);
     
     if (isDucking) {
-        solidrect(x + getWidth() - 8, y + 5, x + getWidth() - 5, y + 8);
+        solidrect(x + width - 8, y + 5, x + width - 5, y + 8);
         solidrect(x, y + 10, x + 5, y + 15);
-        solidrect(x + getWidth() - 5, y + 10, x + getWidth(), y + 15);
+        solidrect(x + width - 5, y + 10, x + width, y + 15);
     } else if (!isJumping) {
-        solidrect(x + getWidth() - 10, y + 8, x + getWidth() - 5, y + 13);
-        solidrect(x + 5, y + getHeight(), x + 10, y + getHeight() + 5);
-        solidrect(x + getWidth() - 10, y + getHeight(), x + getWidth() - 5, y + getHeight() + 5);
+        solidrect(x + width - 10, y + 8, x + width - 5, y + 13);
+        solidrect(x + 5, y + height, x + 10, y + height + 5);
+        solidrect(x + width - 10, y + height, x + width - 5, y + height + 5);
     } else {
-        solidrect(x + getWidth() - 8, y + 10, x + getWidth() - 6, y + 12);
+        solidrect(x + width - 8, y + 10, x + width - 6, y + 12);
     }
+#else
+    (void)palette;
+#endif
 }
 
-void Dinosaur::setPosition(float x, float y) {
+template <class Num>
+void BasicDinosaur<Num>::setPosition(Num x, Num y) {
     this->x = x;
     this->y = y;
 }
 
+// 游戏使用DinoReal，基准程序同时比较float和Fixed16两种实例
+template class BasicDinosaur<float>;
+template class BasicDinosaur<Fixed16>;
+
+/**
+ * @brief 把按键作用到恐龙上
+ * @details 空格：站立且未跳跃时起跳，下蹲中则起身；S：未跳跃时在下蹲和站立之间切换；
+ *          跳跃中两个键都不起作用
+ */
+void applyPlayerInput(Dinosaur& dino, int input) {
+    switch (input) {
+    case INPUT_JUMP_KEY:
+        if (!dino.getIsJumping() && !dino.getIsDucking()) {
+            dino.jump();
+        } else if (dino.getIsDucking()) {
+            dino.stand();
+        }
+        break;
+    case INPUT_DUCK_KEY:
+        if (!dino.getIsJumping()) {
+            if (dino.getIsDucking()) {
+                dino.stand();
+            } else {
+                dino.duck();
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
 // ==================== Obstacle类实现 ====================
 
 /**
  * @brief Obstacle类构造函数
  * @details 初始化障碍物位置、尺寸和基础速度
  */
-Obstacle::Obstacle(float x, float y, float width, float height) 
+Obstacle::Obstacle(DinoReal x, DinoReal y, DinoReal width, DinoReal height) 
     : x(x), y(y), width(width), height(height), speed(5) {}  // 基础速度5像素/帧
 
 Obstacle::~Obstacle() {}
@@ -121,8 +172,8 @@ Obstacle::~Obstacle() {}
  * @param gameSpeed 游戏速度等级（5-12）
  * @details 实际速度 = speed(5) + gameSpeed * 0.15，向左移动（X坐标减少）
  */
-void Obstacle::update(float gameSpeed) {
-    x -= (speed + gameSpeed * 0.15f);  // 综合基础速度和游戏速度加成
+void Obstacle::update(DinoReal gameSpeed) {
+    x -= (speed + gameSpeed * toNumeric<DinoReal>(0.15));  // 综合基础速度和游戏速度加成
 }
 
 /**
@@ -130,8 +181,12 @@ void Obstacle::update(float gameSpeed) {
  * @details 绘制基础矩形，子类可重写以实现特殊样式
  */
 void Obstacle::render() {
+#ifndef DINO_HEADLESS
+    float x = toFloat(this->x), y = toFloat(this->y);
+    float width = toFloat(this->width), height = toFloat(this->height);
     setfillcolor(BLACK);
     solidrect(x, y, x + width, y + height);
+#endif
 }
 
 /**
@@ -153,14 +208,14 @@ bool Obstacle::checkCollision(const Dinosaur& dino) {
  * @brief Cactus类构造函数（默认高度）
  * @details 创建宽度20、高度40的仙人掌
  */
-Cactus::Cactus(float x, float y) : Obstacle(x, y, 20, 40) {}
+Cactus::Cactus(DinoReal x, DinoReal y) : Obstacle(x, y, 20, 40) {}
 
 /**
  * @brief Cactus类构造函数（自定义高度）
  * @param height 仙人掌高度（20-80像素）
  * @details 创建宽度20、高度可变的仙人掌，y坐标自动调整
  */
-Cactus::Cactus(float x, float y, float height) : Obstacle(x, y - height, 20, height) {}
+Cactus::Cactus(DinoReal x, DinoReal y, DinoReal height) : Obstacle(x, y - height, 20, height) {}
 
 Cactus::~Cactus() {}
 
@@ -169,6 +224,9 @@ Cactus::~Cactus() {}
  * @details 绘制主体和分支装饰，形成仙人掌形状
  */
 void Cactus::render() {
+#ifndef DINO_HEADLESS
+    float x = toFloat(this->x), y = toFloat(this->y);
+    float width = toFloat(this->width), height = toFloat(this->height);
     setfillcolor(BLACK);
     solidrect(x, y, x + width, y + height);
     
@@ -177,6 +235,7 @@ void Cactus::render() {
     solidrect(x + width, y + 10, x + width + 5, y + 15);
     solidrect(x + 5, y - 5, x + 10, y);
     solidrect(x + 10, y - 10, x + 15, y - 5);
+#endif
 }
 
 bool Cactus::checkCollision(const Dinosaur& dino) {
@@ -189,7 +248,7 @@ bool Cactus::checkCollision(const Dinosaur& dino) {
  * @brief Bird类构造函数
  * @details 创建宽度30、高度20的飞鸟，初始化翅膀动画参数
  */
-Bird::Bird(float x, float y) : Obstacle(x, y, 30, 20), wingPosition(0), animationCounter(0) {}
+Bird::Bird(DinoReal x, DinoReal y) : Obstacle(x, y, 30, 20), wingPosition(0), animationCounter(0) {}
 
 Bird::~Bird() {}
 
@@ -198,7 +257,7 @@ Bird::~Bird() {}
  * @param gameSpeed 游戏速度等级
  * @details 调用基类更新位置，同时更新翅膀扇动动画（每5帧切换一次）
  */
-void Bird::update(float gameSpeed) {
+void Bird::update(DinoReal gameSpeed) {
     Obstacle::update(gameSpeed);  // 调用基类的位置更新
     
     animationCounter++;
@@ -212,6 +271,9 @@ void Bird::update(float gameSpeed) {
  * @details 绘制身体、翅膀（根据wingPosition切换位置）和眼睛
  */
 void Bird::render() {
+#ifndef DINO_HEADLESS
+    float x = toFloat(this->x), y = toFloat(this->y);
+    float width = toFloat(this->width), height = toFloat(this->height);
     setfillcolor(BLACK);
     solidrect(x, y, x + width, y + height);
     
@@ -224,6 +286,7 @@ void Bird::render() {
     
     setfillcolor(WHITE);
     solidrect(x + 20, y + 5, x + 22, y + 7);
+#endif
 }
 
 /**
@@ -291,28 +354,24 @@ void Background::update() {
 
 /**
  * @brief 渲染背景到屏幕
- * @details 绘制背景色、地面、滚动纹理和云朵装饰，根据昼夜模式调整颜色
+ * @details 绘制地面、滚动纹理和云朵装饰，颜色取自调色板的当前行；
+ *          背景色由DinoGame::render在清屏之前经调色板设置，只在渐变表的行变化时才设置
  */
-void Background::render() {
-    if (isNightMode) {
-        setbkcolor(RGB(50, 50, 50));  // 夜间模式：深灰色背景
-    } else {
-        setbkcolor(WHITE);  // 白天模式：白色背景
-    }
-    
+void Background::render(const DayNightPalette& palette) {
+#ifndef DINO_HEADLESS
     // 绘制地面区域（Y=340-400）
-    setfillcolor(RGB(100, 100, 100));
+    setfillcolor(palette.color(PALETTE_GROUND));
     solidrect(0, 340, 800, 400);
     
     // 绘制地面滚动纹理
-    setfillcolor(RGB(80, 80, 80));
+    setfillcolor(palette.color(PALETTE_GROUND_MARK));
     for (int i = 0; i < 800; i += 20) {
         int offset = (int)groundOffset % 20;
         solidrect(i - offset, 340, i - offset + 10, 350);  // 滚动的地面装饰块
     }
     
     // 绘制静态云朵装饰（多个位置）
-    setfillcolor(RGB(200, 200, 200));
+    setfillcolor(palette.color(PALETTE_CLOUD));
     solidellipse(100, 80, 140, 100);
     solidellipse(120, 70, 160, 90);
     solidellipse(140, 80, 180, 100);
@@ -328,6 +387,9 @@ void Background::render() {
     solidellipse(700, 80, 740, 100);
     solidellipse(720, 70, 760, 90);
     solidellipse(740, 80, 780, 100);
+#else
+    (void)palette;
+#endif
 }
 
 void Background::toggleNightMode(bool night) {
@@ -358,22 +420,23 @@ void ScoreManager::update() {
 
 /**
  * @brief 渲染分数到屏幕
- * @details 在屏幕右上角显示当前分数和最高分，根据昼夜模式调整文字颜色
+ * @details 在屏幕右上角显示当前分数和最高分，文字颜色随调色板从黑色渐变到白色
  */
-void ScoreManager::render() {
+void ScoreManager::render(const DayNightPalette& palette) {
+#ifndef DINO_HEADLESS
     setfont(20, 0, "Arial");
-    
-    if (isNightMode) {
-        setcolor(WHITE);  // 夜间模式白色文字
-    } else {
-        setcolor(BLACK);  // 白天模式黑色文字
-    }
-    
-    std::string scoreText = "Score: " + std::to_string(currentScore);
-    outtextxy(650, 20, scoreText.c_str());
-    
-    std::string highScoreText = "Best: " + std::to_string(highScore);
-    outtextxy(650, 50, highScoreText.c_str());
+    setcolor(palette.color(PALETTE_TEXT));
+    
+    // 文字写入栈上的缓冲区，每帧不产生堆分配
+    char text[32];
+    std::snprintf(text, sizeof(text), "Score: %d", currentScore);
+    outtextxy(650, 20, text);
+    
+    std::snprintf(text, sizeof(text), "Best: %d", highScore);
+    outtextxy(650, 50, text);
+#else
+    (void)palette;
+#endif
 }
 
 void ScoreManager::reset() {
@@ -390,7 +453,9 @@ void ScoreManager::incrementScore(int points) {
  * @brief DinoGame类构造函数
  * @details 初始化游戏状态、速度和计数器
  */
-DinoGame::DinoGame() : isRunning(false), isGameOver(false), gameSpeed(5), frameCount(0), gameOverDelay(0) {}
+DinoGame::DinoGame(size_t arenaCapacity)
+    : arena(arenaCapacity), obstacles(arena.resource()), obstacleAhead(), isRunning(false), isGameOver(false), gameSpeed(5), frameCount(0), gameOverDelay(0),
+      recorder(nullptr), episode(0), lastInput(INPUT_NONE), telemetry(nullptr), tickCount(0), audio(nullptr) {}
 
 DinoGame::~DinoGame() {
     cleanup();
@@ -398,24 +463,37 @@ DinoGame::~DinoGame() {
 
 /**
  * @brief 初始化游戏
- * @details 创建图形窗口，设置标题，初始化随机数种子，重置游戏状态
+ * @details 以当前时间作为障碍物计划种子，每局的赛道都不同
  */
 void DinoGame::initialize() {
+    initialize((uint64_t)time(nullptr));
+}
+
+/**
+ * @brief 以指定种子初始化游戏
+ * @details 创建图形窗口，设置标题，重置障碍物计划和游戏状态。
+ *          重开时障碍物世界先归还内存，再整体重置本局的竞技场
+ */
+void DinoGame::initialize(uint64_t courseSeed) {
     if (isRunning) {
         // 如果已运行，只重置游戏状态
-        obstacles.clear();
+        obstacles.release();  // 清空障碍物世界并归还组件数组的内存
+        arena.reset();        // O(1)释放上一局的全部分配
         score.reset();
+        episode++;
     } else {
+#ifndef DINO_HEADLESS
         // 首次运行，创建窗口
         initgraph(800, 400);  // 创建800x400的窗口
         setcaption("Scu Dino Game");  // 设置窗口标题
         setbkcolor(WHITE);
         cleardevice();
         ege::setrendermode(RENDER_MANUAL);  // 手动渲染模式
-        
-        srand((unsigned int)time(nullptr));  // 初始化随机数生成器
+#endif
     }
     
+    schedule.reset(courseSeed);
+    
     // 重置恐龙位置和游戏状态
     player.setPosition(50, 340 - 60);
     isRunning = true;
@@ -423,6 +501,12 @@ void DinoGame::initialize() {
     frameCount = 0;
     gameOverDelay = 0;
     gameSpeed = 5;  // 重置为初始速度
+    lastInput = INPUT_NONE;
+    palette.reset(false);  // 新的一局从白天开始，不经过渐变
+    if (telemetry) {
+        telemetry->event(TELEMETRY_RESTART, (int32_t)episode, tickCount + 1);
+    }
+    allocations.beginEpisode();
 }
 
 /**
@@ -431,6 +515,7 @@ void DinoGame::initialize() {
  */
 void DinoGame::update() {
     if (!isRunning) return;  // 游戏未运行时直接返回
+    allocations.beginFrame();
     
     if (isGameOver) {
         // 游戏结束状态，只增加延迟计数
@@ -438,6 +523,7 @@ void DinoGame::update() {
         if (gameOverDelay > 90) {  // 90帧（约3秒）后允许重启
             gameOverDelay = 91;
         }
+        publishTelemetry();
         return;
     }
     
@@ -447,86 +533,112 @@ void DinoGame::update() {
     score.update();           // 更新分数
     generateObstacle();       // 生成障碍物
     
-    // 更新所有障碍物位置
-    for (auto& obstacle : obstacles) {
-        obstacle->update(gameSpeed);  // 传入游戏速度等级
-    }
+    // 更新所有障碍物位置（移动系统和动画系统）
+    obstacles.update(gameSpeed);  // 传入游戏速度等级
     
     checkCollisions();    // 检测碰撞
+    
+    // 记录本帧：观测为本帧更新后的状态，动作为本帧处理过的输入
+    if (recorder) {
+        captureDatasetRow(recorder->nextRow(), player, obstacles, obstacleAhead, gameSpeed, lastInput,
+                          isGameOver, episode, frameCount);
+        recorder->commitRow();
+    }
+    lastInput = INPUT_NONE;
+    
     updateGameSpeed();    // 调整游戏速度和昼夜模式
     
+    // 昼夜渐变每步前进一格
+    if (palette.isTransitioning()) {
+        palette.update();
+    }
+    
     frameCount++;  // 帧计数器递增
+    publishTelemetry();
 }
 
 /**
  * @brief 渲染游戏画面（每帧调用）
- * @details 清空画布，依次渲染背景、恐龙、障碍物、分数和游戏结束界面
+ * @details 清空画布，依次渲染背景、恐龙、障碍物、分数和游戏结束界面，
+ *          刷新画面后等待到下一帧截止时间（替代原先固定的delay_ms(30)，帧本身的耗时不再累加到帧间隔上）
  */
 void DinoGame::render() {
+#ifndef DINO_HEADLESS
     if (!isRunning) return;  // 游戏未运行时直接返回
     
-    cleardevice();        // 清空画布
-    background.render();  // 渲染背景
-    player.render();      // 渲染恐龙
+    // 按呈现的帧标记渐变：60/120Hz下没有推进模拟的帧也以混合后的颜色重绘
+    if (palette.isTransitioning()) {
+        pacer.markFrame();
+    }
+    palette.applyBackground();   // 背景色只在渐变表的行变化时设置
+    cleardevice();               // 清空画布
+    background.render(palette);  // 渲染背景
+    player.render(palette);      // 渲染恐龙
     
     // 渲染所有障碍物
-    for (const auto& obstacle : obstacles) {
-        obstacle->render();
-    }
+    obstacles.render(palette);
     
-    score.render();  // 渲染分数
+    score.render(palette);  // 渲染分数
     
     if (isGameOver) {
         showGameOverScreen();  // 显示游戏结束界面
     }
     
-    ege::delay_ms(30);  // 延迟30毫秒，控制帧率约33FPS
+    ege::delay_ms(0);           // 手动渲染模式下刷新画面
+    pacer.waitForNextFrame();   // 按帧节奏策略等待到下一帧截止时间
+#endif
 }
 
 /**
  * @brief 处理键盘输入（每帧调用）
- * @details 检测键盘输入，处理跳跃、下蹲、重启和退出操作
+ * @details 检测键盘输入，每帧最多读取一个按键交给handleKey
  */
 void DinoGame::handleInput() {
+#ifndef DINO_HEADLESS
     if (kbhit()) {  // 检测是否有键盘输入
-        char key = getch();  // 获取按键
-        
-        if (isGameOver) {
-            // 游戏结束状态，按任意键重启（延迟后）
-            if (gameOverDelay >= 91) {
-                initialize();  // 重新初始化游戏
-                isGameOver = false;
-            }
-            return;
-        }
-        
-        // 游戏运行中的按键处理
-        switch (key) {
-        case ' ':   // 空格键
-        case 'w':   // W键
-        case 'W':
-            if (!player.getIsJumping() && !player.getIsDucking()) {
-                player.jump();  // 跳跃
-            } else if (player.getIsDucking()) {
-                player.stand();  // 下蹲中按空格恢复站立
-            }
-            break;
-        case 's':   // S键
-        case 'S':
-        case 80:    // 下箭头键
-            if (!player.getIsJumping()) {
-                if (player.getIsDucking()) {
-                    player.stand();  // 再次按S恢复站立
-                } else {
-                    player.duck();   // 下蹲
-                }
-            }
-            break;
-        case 27:    // ESC键
-            isRunning = false;  // 退出游戏
-            break;
+        handleKey(getch());  // 获取按键
+    }
+#endif
+}
+
+/**
+ * @brief 处理一个按键
+ * @details 把按键映射为PlayerInput交给applyPlayerInput，这里只加上遥测、音效、重启和退出
+ */
+void DinoGame::handleKey(int key) {
+    if (isGameOver) {
+        // 游戏结束状态，按任意键重启（延迟后）
+        if (canRestart()) {
+            initialize();  // 重新初始化游戏
+            isGameOver = false;
         }
+        return;
+    }
+    
+    // 游戏运行中的按键处理
+    int input;
+    switch ((char)key) {
+    case ' ':   // 空格键
+    case 'w':   // W键
+    case 'W':
+        input = INPUT_JUMP_KEY;
+        break;
+    case 's':   // S键
+    case 'S':
+    case 80:    // 下箭头键
+        input = INPUT_DUCK_KEY;
+        break;
+    case 27:    // ESC键
+        isRunning = false;  // 退出游戏
+        return;
+    default:
+        return;
     }
+    lastInput = input;
+    if (telemetry) telemetry->event(TELEMETRY_INPUT, input, tickCount + 1);
+    const bool wasJumping = player.getIsJumping();
+    applyPlayerInput(player, input);
+    if (audio && !wasJumping && player.getIsJumping()) audio->post(AUDIO_JUMP);
 }
 
 /**
@@ -534,6 +646,7 @@ void DinoGame::handleInput() {
  * @details 显示Game Over文字、分数和重启倒计时提示
  */
 void DinoGame::showGameOverScreen() {
+#ifndef DINO_HEADLESS
     setfont(30, 0, "Arial Bold");
     setcolor(RED);
     
@@ -546,20 +659,22 @@ void DinoGame::showGameOverScreen() {
     outtextxy(gameOverXPos, 150, gameOverText);
     
     // 显示分数（居中）
-    std::string scoreText = "Score: " + std::to_string(score.getCurrentScore());
-    int scoreTextWidth = textwidth(scoreText.c_str());
+    char scoreText[32];
+    std::snprintf(scoreText, sizeof(scoreText), "Score: %d", score.getCurrentScore());
+    int scoreTextWidth = textwidth(scoreText);
     int scoreXPos = (800 - scoreTextWidth) / 2;
-    outtextxy(scoreXPos, 200, scoreText.c_str());
+    outtextxy(scoreXPos, 200, scoreText);
     
     setfont(20, 0, "Arial Bold");
     
     // 显示重启提示（带倒计时）
     if (gameOverDelay > 0 && gameOverDelay <= 90) {
         int remainingTime = (90 - gameOverDelay) / 30 + 1;  // 3秒倒计时
-        std::string restartText = "Press any key to restart in " + std::to_string(remainingTime) + "s";
-        int textWidth = textwidth(restartText.c_str());
+        char restartText[64];
+        std::snprintf(restartText, sizeof(restartText), "Press any key to restart in %ds", remainingTime);
+        int textWidth = textwidth(restartText);
         int xPos = (800 - textWidth) / 2;
-        outtextxy(xPos, 250, restartText.c_str());
+        outtextxy(xPos, 250, restartText);
     } else if (gameOverDelay >= 91) {
         // 延迟结束，显示可以重启
         const char* restartText = "Press any key to restart";
@@ -567,6 +682,7 @@ void DinoGame::showGameOverScreen() {
         int xPos = (800 - textWidth) / 2;
         outtextxy(xPos, 250, restartText);
     }
+#endif
 }
 
 /**
@@ -574,65 +690,52 @@ void DinoGame::showGameOverScreen() {
  * @details 关闭图形窗口，释放资源
  */
 void DinoGame::cleanup() {
+#ifndef DINO_HEADLESS
     closegraph();  // 关闭EGE图形窗口
+#endif
 }
 
 /**
  * @brief 动态生成障碍物
- * @details 按帧计数生成仙人掌或飞鸟，生成间隔随速度缩短，自动清理超出屏幕的障碍物
+ * @details 从障碍物生成计划中取出当前帧的生成记录，自动清理超出屏幕的障碍物
  * 
- * 生成间隔：max(20, 80 - gameSpeed*2)帧，速度越快间隔越短
- * 类型选择：
- *   - 随机数0-5，<3生成仙人掌，否则生成飞鸟
+ * 生成规则（见ObstacleSchedule和DifficultyProfile）：
+ *   - 生成间隔：max(20, 80 - gameSpeed*2)帧，速度越快间隔越短
+ *   - 类型：0-5的随机数，<3生成仙人掌，否则生成飞鸟
  *   - 仙人掌高度随机：20-80像素（7个等级）
  *   - 飞鸟高度随机：260-320像素（7个等级）
+ *   - 速度达到8级后，部分仙人掌变为2-3株并排的仙人掌丛
+ *   - 随机数由(种子, 帧号)哈希得到，任意帧的障碍物都可以直接查询
  * 内存管理：
- *   - 使用remove_if清理X<-50的障碍物
- *   - 智能指针自动释放内存
+ *   - 障碍物存放在ObstacleWorld的组件数组中，清理时原地压缩X<-50的实体
  */
 void DinoGame::generateObstacle() {
-    // 根据游戏速度计算生成间隔，速度越快间隔越短
-    if (frameCount % std::max(20, 80 - gameSpeed * 2) == 0) {
-        int type = rand() % 6;  // 随机生成类型0-5
-        if (type < 3) {
-            // 生成仙人掌（概率50%）
-            int cactusHeight = 20 + (rand() % 7) * 10;  // 高度随机20-80
-            obstacles.push_back(std::make_unique<Cactus>(800, 340, cactusHeight));
-        } else {
-            // 生成飞鸟（概率50%）
-            int birdHeight = 260 + (rand() % 7) * 10;  // 高度随机260-320
-            obstacles.push_back(std::make_unique<Bird>(800, birdHeight));
-        }
+    ScheduledSpawn spawn;
+    if (schedule.spawnAt(frameCount, spawn)) {
+        obstacles.spawn(spawn);
     }
     
     // 清理已经移出屏幕左侧的障碍物（X<-50）
-    obstacles.erase(
-        std::remove_if(obstacles.begin(), obstacles.end(),
-            [](const std::unique_ptr<Obstacle>& obs) {
-                return obs->getX() < -50;  // 判断是否超出屏幕
-            }),
-        obstacles.end()
-    );  // erase-remove习惯用法清理容器
+    obstacles.removeOffscreen();
 }
 
 /**
  * @brief 检测所有障碍物与恐龙的碰撞
- * @details 遍历障碍物容器，一旦检测到碰撞立即设置游戏结束状态
+ * @details 由障碍物世界的碰撞系统逐种类检测，一旦检测到碰撞立即设置游戏结束状态
  * 
  * 检测流程：
- *   - 遍历obstacles容器中的每个障碍物
- *   - 调用障碍物的checkCollision方法
- *   - 传入player对象进行碰撞判定
+ *   - 按种类遍历组件池，碰撞规则在编译期按种类展开
+ *   - 飞鸟按碰撞规则组件区分跳跃躲避和下蹲躲避
  * 终止逻辑：
- *   - 一旦检测到碰撞，设置isGameOver=true
- *   - 立即break跳出循环，无需继续检测
+ *   - 任一实体碰撞即返回，设置isGameOver=true
  */
 void DinoGame::checkCollisions() {
-    for (const auto& obstacle : obstacles) {
-        if (obstacle->checkCollision(player)) {  // 调用障碍物的碰撞检测方法
-            isGameOver = true;  // 设置游戏结束标志
-            break;              // 立即终止检测
+    if (obstacles.checkCollision(player, obstacleAhead)) {
+        isGameOver = true;  // 设置游戏结束标志
+        if (telemetry) {
+            telemetry->event(TELEMETRY_GAME_OVER, score.getCurrentScore(), tickCount + 1);
         }
+        if (audio) audio->post(AUDIO_GAME_OVER);
     }
 }
 
@@ -649,15 +752,47 @@ void DinoGame::checkCollisions() {
  *   - 每700分切换一次模式
  *   - 通过 (分数/700) % 2 判断奇偶
  *   - 奇数为夜间模式，偶数为白天模式
+ *   - 模式（getIsNightMode）在该帧切换，画面颜色由调色板在之后的若干帧内渐变
  */
 void DinoGame::updateGameSpeed() {
     // 根据分数计算新速度等级
     int newSpeed = 5 + (score.getCurrentScore() / 200);  // 每200分+1级
     if (newSpeed > 12) newSpeed = 12;  // 限制最高速度12级
+    if (audio && !isGameOver) {
+        // 升级的一帧只播放加速音效，其余每100分播放里程碑音效；本帧已碰撞时只保留结束音效
+        if (newSpeed > gameSpeed) {
+            audio->post(AUDIO_SPEED_UP);
+        } else if (score.getCurrentScore() % 100 == 0) {
+            audio->post(AUDIO_MILESTONE);
+        }
+    }
     gameSpeed = newSpeed;
     
     // 根据分数切换昼夜模式
     bool isNight = (score.getCurrentScore() / 700) % 2 == 1;  // 每700分切换，奇数为夜间
     background.toggleNightMode(isNight);  // 设置背景模式
     score.setNightMode(isNight);          // 设置分数显示模式
-}
\ No newline at end of file
+    palette.setNight(isNight);            // 颜色在之后的若干帧内渐变到目标模式
+}
+
+/**
+ * @brief 发布本帧的遥测快照
+ * @details 每次update（包括结束画面期间）发布一次，发布端只写共享内存，不会阻塞游戏循环
+ */
+void DinoGame::publishTelemetry() {
+    tickCount++;
+    if (!telemetry) return;
+    TelemetrySnapshot snapshot;
+    snapshot.frame = tickCount;
+    snapshot.episode = episode;
+    snapshot.score = score.getCurrentScore();
+    snapshot.highScore = score.getHighScore();
+    snapshot.gameSpeed = gameSpeed;
+    snapshot.obstaclesAlive = (int32_t)obstacles.size();
+    snapshot.dinoY = toFloat(player.getY());
+    snapshot.jumping = player.getIsJumping();
+    snapshot.ducking = player.getIsDucking();
+    snapshot.gameOver = isGameOver;
+    snapshot.nightMode = background.getIsNightMode();
+    telemetry->publish(snapshot);
+}
@@ -9,21 +9,45 @@
 
 #include <vector>
 #include <memory>
+#include "FixedPoint.h"
+#include "ObstacleWorld.h"
+#include "FramePacer.h"
+#include "MemoryTracking.h"
+#include "DayNightPalette.h"
+
+// DINO_HEADLESS：无图形界面构建（训练器等离线工具），不依赖EGE，渲染函数为空实现
+#ifndef DINO_HEADLESS
 #include <graphics.h>
 #include <ege.h>
+#endif
 
-class Dinosaur;
 class Obstacle;
+class DatasetWriter;
+class TelemetryPublisher;
+class AudioMixer;
 
 /**
- * @class Dinosaur
+ * @enum PlayerInput
+ * @brief 每帧最多一次的按键输入（DinoGame::handleInput每帧只读取一个按键）
+ */
+enum PlayerInput {
+    INPUT_NONE = 0,         // 无按键
+    INPUT_JUMP_KEY = 1,     // 空格/W
+    INPUT_DUCK_KEY = 2,     // S/下箭头
+    INPUT_COUNT = 3
+};
+
+/**
+ * @class BasicDinosaur
  * @brief 恐龙玩家类
- * @details 负责恐龙角色的跳跃、下蹲、移动和渲染，实现简化的物理模拟
+ * @details 负责恐龙角色的跳跃、下蹲、移动和渲染，实现简化的物理模拟。
+ *          Num为模拟数值类型（float或Fixed16），游戏使用的是Dinosaur = BasicDinosaur<DinoReal>
  */
-class Dinosaur {
+template <class Num>
+class BasicDinosaur {
 private:
-    float x, y;                          // 恐龙在屏幕上的位置坐标（x固定为50，y根据跳跃状态变化）
-    float velocityY;                     // 垂直方向速度，用于跳跃物理模拟（负数向上，正数向下）
+    Num x, y;                            // 恐龙在屏幕上的位置坐标（x固定为50，y根据跳跃状态变化）
+    Num velocityY;                       // 垂直方向速度，用于跳跃物理模拟（负数向上，正数向下）
     bool isJumping;                      // 是否处于跳跃状态
     bool isDucking;                      // 是否处于下蹲状态
     int groundLevel;                     // 地面基准线Y=340，所有地面实体的参考坐标
@@ -32,8 +56,8 @@ private:
     static const int DINO_HEIGHT_DUCK = 30; // 恐龙下蹲高度，用于躲避飞鸟
 
 public:
-    Dinosaur();
-    ~Dinosaur();
+    BasicDinosaur();
+    ~BasicDinosaur();
 
     /**
      * @brief 执行跳跃动作
@@ -61,33 +85,43 @@ public:
     
     /**
      * @brief 渲染恐龙到屏幕
-     * @details 根据当前状态（站立/下蹲/跳跃）绘制不同形态的恐龙图形
+     * @details 根据当前状态（站立/下蹲/跳跃）绘制不同形态的恐龙图形，颜色取自调色板
      */
-    void render();
+    void render(const DayNightPalette& palette);
 
-    float getX() const { return x; }
-    float getY() const { return y; }
-    float getWidth() const { return DINO_WIDTH; }
-    float getHeight() const { return isDucking ? DINO_HEIGHT_DUCK : DINO_HEIGHT; }
+    Num getX() const { return x; }
+    Num getY() const { return y; }
+    Num getWidth() const { return Num(DINO_WIDTH); }
+    Num getHeight() const { return Num(isDucking ? DINO_HEIGHT_DUCK : DINO_HEIGHT); }
+    Num getVelocityY() const { return velocityY; }
     bool getIsJumping() const { return isJumping; }
     bool getIsDucking() const { return isDucking; }
 
-    void setPosition(float x, float y);
+    void setPosition(Num x, Num y);
 };
 
+typedef BasicDinosaur<DinoReal> Dinosaur;
+
+/**
+ * @brief 把按键作用到恐龙上
+ * @details 跳跃/下蹲规则的唯一实现：DinoGame::handleKey、分析器、对照测试和训练器都调用它
+ */
+void applyPlayerInput(Dinosaur& dino, int input);
+
 /**
  * @class Obstacle
  * @brief 障碍物基类
- * @details 定义障碍物的通用行为：移动、渲染、碰撞检测。派生类包括Cactus和Bird
+ * @details 定义障碍物的通用行为：移动、渲染、碰撞检测。派生类包括Cactus和Bird。
+ *          游戏本身已改用ObstacleWorld（组件数组+编译期分派），这组虚函数类保留作为对照实现和基准
  */
 class Obstacle {
 protected:
-    float x, y;              // 障碍物位置坐标
-    float width, height;     // 障碍物尺寸
-    float speed;             // 基础移动速度（固定为5像素/帧）
+    DinoReal x, y;           // 障碍物位置坐标
+    DinoReal width, height;  // 障碍物尺寸
+    DinoReal speed;          // 基础移动速度（固定为5像素/帧）
 
 public:
-    Obstacle(float x, float y, float width, float height);
+    Obstacle(DinoReal x, DinoReal y, DinoReal width, DinoReal height);
     virtual ~Obstacle();
 
     /**
@@ -95,7 +129,7 @@ public:
      * @param gameSpeed 游戏速度等级，影响实际移动速度
      * @details 实际速度 = speed + gameSpeed * 0.15，向左移动（X坐标减少）
      */
-    virtual void update(float gameSpeed = 0.0f);
+    virtual void update(DinoReal gameSpeed = 0);
     
     /**
      * @brief 渲染障碍物到屏幕
@@ -110,10 +144,10 @@ public:
      */
     virtual bool checkCollision(const Dinosaur& dino);
 
-    float getX() const { return x; }
-    float getY() const { return y; }
-    float getWidth() const { return width; }
-    float getHeight() const { return height; }
+    DinoReal getX() const { return x; }
+    DinoReal getY() const { return y; }
+    DinoReal getWidth() const { return width; }
+    DinoReal getHeight() const { return height; }
 };
 
 /**
@@ -123,8 +157,8 @@ public:
  */
 class Cactus : public Obstacle {
 public:
-    Cactus(float x, float y);
-    Cactus(float x, float y, float height);
+    Cactus(DinoReal x, DinoReal y);
+    Cactus(DinoReal x, DinoReal y, DinoReal height);
     virtual ~Cactus();
 
     virtual void render() override;
@@ -142,10 +176,10 @@ private:
     int animationCounter;    // 动画计数器，每5帧切换一次翅膀状态
 
 public:
-    Bird(float x, float y);
+    Bird(DinoReal x, DinoReal y);
     virtual ~Bird();
 
-    virtual void update(float gameSpeed = 0.0f) override;
+    virtual void update(DinoReal gameSpeed = 0) override;
     virtual void render() override;
     virtual bool checkCollision(const Dinosaur& dino) override;
 };
@@ -166,7 +200,7 @@ public:
     ~Background();
 
     void update();
-    void render();
+    void render(const DayNightPalette& palette);
     void toggleNightMode(bool night);
 
     bool getIsNightMode() const { return isNightMode; }
@@ -188,7 +222,7 @@ public:
     ~ScoreManager();
 
     void update();
-    void render();
+    void render(const DayNightPalette& palette);
     void reset();
 
     void incrementScore(int points = 1);
@@ -206,18 +240,33 @@ public:
  */
 class DinoGame {
 private:
+    EpisodeArena arena;                                 // 每局的单调竞技场（须先于使用它的容器构造）
+    AllocationTracker allocations;                      // 每帧、每局的堆分配统计
     Dinosaur player;                                    // 玩家恐龙实例
-    std::vector<std::unique_ptr<Obstacle>> obstacles;   // 障碍物容器（使用智能指针自动管理内存）
+    ObstacleWorld obstacles;                            // 障碍物世界（组件数组从arena分配）
+    ObstacleAhead obstacleAhead;                        // 本帧碰撞检测时各组件池中恐龙前方的第一个实体
     Background background;                              // 背景渲染器
     ScoreManager score;                                 // 分数管理器
+    DayNightPalette palette;                            // 昼夜渐变调色板（只影响渲染）
+    ObstacleSchedule schedule;                          // 障碍物生成计划（由种子决定，可按帧随机访问）
+    FramePacer pacer;                                   // 帧节奏控制器（默认固定30Hz）
     bool isRunning;                                     // 游戏是否正在运行
     bool isGameOver;                                    // 游戏是否结束
     int gameSpeed;                                      // 当前游戏速度等级（5-12）
     int frameCount;                                     // 帧计数器，用于计算障碍物生成时机
     int gameOverDelay;                                  // 游戏结束延迟计数器，控制重启倒计时（3秒）
+    DatasetWriter* recorder;                            // 对局数据集写入器（为空时不记录）
+    uint32_t episode;                                   // 本局的局号（每次initialize递增）
+    int lastInput;                                      // 本帧处理过的输入（PlayerInput）
+    TelemetryPublisher* telemetry;                      // 共享内存遥测发布端（为空时不发布）
+    uint64_t tickCount;                                 // 游戏循环的更新次数（含结束画面），作为遥测的帧序号
+    AudioMixer* audio;                                  // 音效混音器（为空时没有声音）
 
 public:
-    DinoGame();
+    /**
+     * @param arenaCapacity 每局竞技场的初始缓冲区大小（同时运行大量对局的服务器使用较小的值）
+     */
+    explicit DinoGame(size_t arenaCapacity = EpisodeArena::DEFAULT_CAPACITY);
     ~DinoGame();
 
     /**
@@ -225,6 +274,11 @@ public:
      * @details 创建窗口、重置状态、初始化随机数种子
      */
     void initialize();
+
+    /**
+     * @brief 以指定的障碍物计划种子初始化（脚本化运行和差分对照使用，结果可复现）
+     */
+    void initialize(uint64_t courseSeed);
     
     /**
      * @brief 更新游戏逻辑（每帧调用）
@@ -234,7 +288,8 @@ public:
     
     /**
      * @brief 渲染游戏画面（每帧调用）
-     * @details 清空画布，依次渲染背景、恐龙、障碍物、分数，显示游戏结束界面
+     * @details 清空画布，依次渲染背景、恐龙、障碍物、分数，显示游戏结束界面，
+     *          刷新画面后由帧节奏控制器等待到下一帧
      */
     void render();
     
@@ -243,6 +298,11 @@ public:
      * @details 检测空格/W/S/ESC键，控制跳跃、下蹲和退出
      */
     void handleInput();
+
+    /**
+     * @brief 处理一个按键（handleInput读到按键后调用，也供脚本化输入使用）
+     */
+    void handleKey(int key);
     
     /**
      * @brief 清理资源
@@ -251,12 +311,56 @@ public:
     void cleanup();
 
     bool isGameRunning() const { return isRunning; }
+    bool getIsGameOver() const { return isGameOver; }
+
+    /**
+     * @brief 结束画面的延迟是否已过，此时按键会开始新的一局
+     */
+    bool canRestart() const { return isGameOver && gameOverDelay >= 91; }
     int getCurrentScore() const { return score.getCurrentScore(); }
+    uint32_t getEpisode() const { return episode; }
+    uint64_t getCourseSeed() const { return schedule.getSeed(); }
+    int getGameSpeed() const { return gameSpeed; }
+    int getFrameCount() const { return frameCount; }
+    bool getIsNightMode() const { return background.getIsNightMode(); }
+    const Dinosaur& getPlayer() const { return player; }
+    const ObstacleWorld& getObstacles() const { return obstacles; }
+
+    void setPacingPolicy(PacingPolicy policy) { pacer.setPolicy(policy); }
+
+    /**
+     * @brief 本帧应调用update的次数（游戏逻辑固定30Hz，与帧节奏策略无关）
+     */
+    int takeSimulationSteps() { return pacer.takeSimulationSteps(); }
+
+    /**
+     * @brief 设置昼夜切换的渐变帧数（小于等于1时为硬切换）
+     */
+    void setFadeFrames(int frames) { palette.setTransitionFrames(frames); }
+    const DayNightPalette& getPalette() const { return palette; }
+    const FramePacer& getFramePacer() const { return pacer; }
+    const AllocationTracker& getAllocationTracker() const { return allocations; }
+    const EpisodeArena& getArena() const { return arena; }
+
+    /**
+     * @brief 设置对局数据集写入器，每个存活帧在碰撞检测之后记录一行（传nullptr停止记录）
+     */
+    void setRecorder(DatasetWriter* writer) { recorder = writer; }
+
+    /**
+     * @brief 设置遥测发布端，每次update结束时发布快照，按键、碰撞和重开时写入事件（传nullptr停止发布）
+     */
+    void setTelemetry(TelemetryPublisher* publisher) { telemetry = publisher; }
+
+    /**
+     * @brief 设置音效混音器，起跳、每100分、速度提升和碰撞时投递音效事件（传nullptr关闭声音）
+     */
+    void setAudio(AudioMixer* mixer) { audio = mixer; }
 
 private:
     /**
      * @brief 动态生成障碍物
-     * @details 按帧计数生成仙人掌或飞鸟，生成间隔随速度缩短，自动清理超出屏幕的障碍物
+     * @details 按生成计划在当前帧生成仙人掌或飞鸟，自动清理超出屏幕的障碍物
      */
     void generateObstacle();
     
@@ -271,6 +375,11 @@ private:
      * @details 每200分增加1级速度（上限12级），每700分切换一次昼夜模式
      */
     void updateGameSpeed();
+
+    /**
+     * @brief 发布本帧的遥测快照
+     */
+    void publishTelemetry();
     
     /**
      * @brief 显示游戏结束界面
@@ -6,36 +6,143 @@
  * 主循环流程：
  * 1. 创建DinoGame对象
  * 2. 调用initialize初始化游戏窗口和资源
- * 3. while循环每帧执行：handleInput -> update -> render
+ * 3. while循环每帧执行：handleInput -> update（按固定30Hz步长，每帧0到若干次） -> render
  * 4. 退出循环后调用cleanup清理资源
- * 5. 输出最终分数
+ * 5. 输出最终分数和帧节奏统计
+ *
+ * 用法：dino_game [--pacing 30|60|120|uncapped|powersave] [--record 文件] [--telemetry 段名]
+ *                  [--audio device|null|off|文件.wav] [--fade 帧数]
+ *   --pacing 呈现的帧节奏策略；游戏逻辑固定以30Hz步长推进，不随帧率变快
+ *   --record 把每帧的状态、动作和奖励写入列式数据集（见EpisodeDataset.h）
+ *   --telemetry 每帧把状态发布到POSIX共享内存段（如/dino_telemetry），用dino_telemetry查看
+ *   --audio 音效输出：声卡（只有Windows，且为Windows下的默认值）、空输出、关闭或写入WAV文件
+ *   --fade 昼夜切换的颜色渐变帧数（默认60，0为硬切换）
  */
 
 #include "OptimizedDinoGame.h"
+#include "EpisodeDataset.h"
+#include "Telemetry.h"
+#include "AudioMixer.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 /**
  * @brief 程序主入口
  * @return 程序退出状态码
  * @details 创建游戏实例，运行游戏主循环，清理资源并输出最终分数
  */
-int main() {
+int main(int argc, char** argv) {
     DinoGame game;  // 创建游戏对象
     
+    DatasetWriter recorder;
+    TelemetryPublisher telemetry;
+    AudioMixer audio;
+    std::unique_ptr<AudioSink> audioSink;
+#ifdef _WIN32
+    std::string audioOutput = "device";
+#else
+    std::string audioOutput = "off";
+#endif
+    
+    // 可选的帧节奏策略和数据集记录
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            const char* options[] = {"--pacing", "--record", "--telemetry", "--audio", "--fade"};
+            bool known = false;
+            for (const char* option : options) {
+                known = known || std::strcmp(argv[i], option) == 0;
+            }
+            std::cerr << (known ? "missing value for option: " : "unknown option: ") << argv[i] << std::endl;
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--pacing") == 0) {
+            PacingPolicy policy;
+            if (!FramePacer::parsePolicy(argv[i + 1], policy)) {
+                std::cerr << "unknown pacing policy: " << argv[i + 1] << std::endl;
+                return 1;
+            }
+            game.setPacingPolicy(policy);
+        } else if (std::strcmp(argv[i], "--record") == 0) {
+            if (!recorder.open(argv[i + 1])) {
+                std::cerr << "cannot write " << argv[i + 1] << std::endl;
+                return 1;
+            }
+            game.setRecorder(&recorder);
+        } else if (std::strcmp(argv[i], "--telemetry") == 0) {
+            if (!telemetry.open(argv[i + 1])) {
+                std::cerr << "cannot create shared memory " << argv[i + 1] << std::endl;
+                return 1;
+            }
+            game.setTelemetry(&telemetry);
+        } else if (std::strcmp(argv[i], "--audio") == 0) {
+            audioOutput = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--fade") == 0) {
+            game.setFadeFrames(std::atoi(argv[i + 1]));
+        } else {
+            std::cerr << "unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    
+    // 音效：混音线程在游戏开始前启动，输出端不可用时没有声音但游戏照常运行
+    if (audioOutput != "off") {
+        if (audioOutput == "null") {
+            audioSink.reset(new NullAudioSink());
+#ifdef _WIN32
+        } else if (audioOutput == "device") {
+            audioSink.reset(new WaveOutAudioSink());
+#endif
+        } else if (audioOutput.size() > 4 && audioOutput.compare(audioOutput.size() - 4, 4, ".wav") == 0) {
+            audioSink.reset(new WavFileAudioSink(audioOutput));
+        } else {
+            std::cerr << "unknown audio output: " << audioOutput << std::endl;
+            return 1;
+        }
+        audio.loadDefaultClips();
+        if (audio.start(audioSink.get())) {
+            game.setAudio(&audio);
+        } else {
+            std::cerr << "audio output unavailable: " << audioOutput << std::endl;
+        }
+    }
+    
     game.initialize();  // 初始化游戏窗口和资源
     
     // 游戏主循环：持续运行直到用户按ESC退出
     while (game.isGameRunning()) {
         game.handleInput();  // 处理键盘输入
-        game.update();       // 更新游戏逻辑
+        for (int steps = game.takeSimulationSteps(); steps > 0; steps--) {
+            game.update();   // 以固定步长更新游戏逻辑
+        }
         game.render();       // 渲染游戏画面
     }
     
     game.cleanup();  // 清理资源，关闭窗口
+    bool audioStarted = audio.isRunning();
+    game.setAudio(nullptr);
+    audio.stop();
     
     // 输出最终分数到控制台
     std::cout << "Game Over! Final Score: " << game.getCurrentScore() << std::endl;
+    game.getFramePacer().report(std::cout);
+    game.getAllocationTracker().report(std::cout);
+    if (audioStarted) {
+        audio.report(std::cout);
+    }
+    if (recorder.isOpen()) {
+        long long rows = recorder.getRowCount();
+        if (!recorder.close()) {
+            std::cerr << "dataset write failed" << std::endl;
+            return 1;
+        }
+        std::cout << "recorded " << rows << " frames" << std::endl;
+    }
     
     return 0;  // 程序正常结杞
 }
\ No newline at end of file
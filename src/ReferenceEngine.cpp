@@ -0,0 +1,223 @@
+/**
+ * @file ReferenceEngine.cpp
+ * @brief 参考引擎实现文件
+ * @details 规则逐条对应冻结时的游戏代码，注释中注明了出处；数值运算的顺序和类型保持原样，
+ *          使float和Fixed16两种实例都能与对应构建的游戏逐位一致
+ */
+
+#include "ReferenceEngine.h"
+#include "OptimizedDinoGame.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief SplitMix64哈希（与ObstacleSchedule相同）
+ */
+uint64_t referenceHash(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+const int GROUND_LEVEL = 340;
+const int DINO_HEIGHT = 60;
+const int DINO_HEIGHT_DUCK = 30;
+
+}  // namespace
+
+template <class Num>
+BasicReferenceEngine<Num>::BasicReferenceEngine()
+    : seed(0), dinoY(GROUND_LEVEL - DINO_HEIGHT), dinoVelocityY(0), jumping(false), ducking(false),
+      score(0), gameSpeed(5), frameCount(0), gameOver(false), night(false) {}
+
+/**
+ * @details 对应DinoGame::initialize：恐龙只被放回站立位置，跳跃、下蹲标志和垂直速度保持原样
+ *          （重开时恐龙的这部分状态沿用上一局，这是游戏现有的行为）
+ */
+template <class Num>
+void BasicReferenceEngine<Num>::reset(uint64_t newSeed) {
+    seed = newSeed;
+    obstacles.clear();
+    score = 0;
+    dinoY = Num(GROUND_LEVEL - DINO_HEIGHT);
+    gameOver = false;
+    frameCount = 0;
+    gameSpeed = 5;
+}
+
+// Dinosaur::jump/duck/stand
+template <class Num>
+void BasicReferenceEngine<Num>::dinoJump() {
+    if (!jumping && !ducking) {
+        jumping = true;
+        dinoVelocityY = -15;
+    }
+}
+
+template <class Num>
+void BasicReferenceEngine<Num>::dinoDuck() {
+    if (!jumping) {
+        ducking = true;
+        dinoY = Num(GROUND_LEVEL) - DINO_HEIGHT_DUCK;
+    }
+}
+
+template <class Num>
+void BasicReferenceEngine<Num>::dinoStand() {
+    ducking = false;
+    dinoY = Num(GROUND_LEVEL) - DINO_HEIGHT;
+}
+
+// DinoGame::handleKey（游戏进行中）
+template <class Num>
+void BasicReferenceEngine<Num>::press(int input) {
+    if (gameOver) return;
+    switch (input) {
+    case INPUT_JUMP_KEY:
+        if (!jumping && !ducking) {
+            dinoJump();
+        } else if (ducking) {
+            dinoStand();
+        }
+        break;
+    case INPUT_DUCK_KEY:
+        if (!jumping) {
+            if (ducking) {
+                dinoStand();
+            } else {
+                dinoDuck();
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// Obstacle::checkCollision和Bird::checkCollision
+template <class Num>
+bool BasicReferenceEngine<Num>::collides(const Body& body) const {
+    const Num dinoHeight = Num(ducking ? DINO_HEIGHT_DUCK : DINO_HEIGHT);
+    if (body.kind == OBSTACLE_BIRD) {
+        if (body.y >= Num(310)) {
+            if (jumping && dinoY + dinoHeight <= body.y) {
+                return false;
+            }
+        } else {
+            if (ducking && dinoY + dinoHeight <= body.y + Num(20)) {
+                return false;
+            }
+        }
+    }
+    return getDinoX() + getDinoWidth() > body.x &&
+           getDinoX() < body.x + body.width &&
+           dinoY + dinoHeight > body.y &&
+           dinoY < body.y + body.height;
+}
+
+/**
+ * @details 对应DinoGame::update中非结束状态的部分，顺序为：
+ *          恐龙物理、加分、按计划生成、清理X<-50、移动和动画、碰撞、速度与昼夜、帧计数
+ */
+template <class Num>
+void BasicReferenceEngine<Num>::step() {
+    if (gameOver) return;
+
+    // Dinosaur::update
+    if (jumping) {
+        dinoY += dinoVelocityY;
+        dinoVelocityY += 1;
+        if (dinoY >= Num(GROUND_LEVEL) - DINO_HEIGHT) {
+            dinoY = Num(GROUND_LEVEL) - DINO_HEIGHT;
+            jumping = false;
+            dinoVelocityY = 0;
+        }
+    }
+
+    // ScoreManager::update
+    score++;
+
+    // DinoGame::generateObstacle
+    ScheduledSpawn spawn;
+    if (spawnAt(seed, frameCount, spawn)) {
+        Body body;
+        body.kind = spawn.kind;
+        body.x = Num(800);
+        body.animationCounter = 0;
+        body.wing = 0;
+        if (spawn.kind == OBSTACLE_BIRD) {
+            body.y = Num(spawn.height);
+            body.width = Num(30);
+            body.height = Num(20);
+        } else {
+            body.y = Num(GROUND_LEVEL - spawn.height);
+            body.width = Num(spawn.count * 20 + (spawn.count - 1) * 5);
+            body.height = Num(spawn.height);
+        }
+        obstacles.push_back(body);
+    }
+    obstacles.erase(std::remove_if(obstacles.begin(), obstacles.end(),
+                                   [](const Body& body) { return body.x < Num(-50); }),
+                    obstacles.end());
+
+    // Obstacle::update和Bird::update
+    const Num speedLevel = Num(gameSpeed);
+    for (Body& body : obstacles) {
+        body.x -= (Num(5) + speedLevel * toNumeric<Num>(0.15));
+        if (body.kind == OBSTACLE_BIRD) {
+            body.animationCounter++;
+            if (body.animationCounter % 5 == 0) {
+                body.wing = (body.wing + 1) % 2;
+            }
+        }
+    }
+
+    // DinoGame::checkCollisions
+    for (const Body& body : obstacles) {
+        if (collides(body)) {
+            gameOver = true;
+            break;
+        }
+    }
+
+    // DinoGame::updateGameSpeed
+    gameSpeed = std::min(12, 5 + score / 200);
+    night = (score / 700) % 2 == 1;
+
+    frameCount++;
+}
+
+/**
+ * @details 生成间隔随速度等级缩短，速度等级取本帧开始时的分数（即帧号）；
+ *          类型、高度和仙人掌丛取自splitmix64(种子 ^ splitmix64(帧号))的不同位段
+ */
+template <class Num>
+bool BasicReferenceEngine<Num>::spawnAt(uint64_t seed, int frame, ScheduledSpawn& spawn) {
+    if (frame < 0) return false;
+    int speed = std::min(12, 5 + frame / 200);
+    int interval = std::max(20, 80 - speed * 2);
+    if (frame % interval != 0) return false;
+
+    uint64_t bits = referenceHash(seed ^ referenceHash((uint64_t)frame));
+    int level = (int)((bits >> 32) % 7);
+    spawn.frame = frame;
+    spawn.count = 1;
+    if ((int)(bits % 6) >= 3) {
+        spawn.kind = OBSTACLE_BIRD;
+        spawn.height = 260 + level * 10;
+    } else {
+        spawn.kind = OBSTACLE_CACTUS;
+        spawn.height = 20 + level * 10;
+        if (speed >= 8 && ((bits >> 16) & 0xFF) % 3 == 0) {
+            spawn.kind = OBSTACLE_CACTUS_CLUSTER;
+            spawn.count = 2 + (int)((bits >> 24) & 1);
+            spawn.height = std::min(spawn.height, 50);
+        }
+    }
+    return true;
+}
+
+template class BasicReferenceEngine<float>;
+template class BasicReferenceEngine<Fixed16>;
@@ -0,0 +1,96 @@
+/**
+ * @file ReferenceEngine.h
+ * @brief 参考引擎头文件
+ * @details 把当前DinoGame::update、generateObstacle、checkCollisions、updateGameSpeed和按键处理的规则
+ *          冻结为一个独立、直白的实现：障碍物按出生顺序放在一个数组里，生成规则直接按帧哈希计算，
+ *          不经过ObstacleWorld、ObstacleSchedule、竞技场等任何优化过的组件。
+ *
+ *          以后的优化（批处理、SIMD、内存池、固定步长等）不应修改这个文件；
+ *          dino_diff把优化后的引擎与它逐帧对照，证明行为没有改变。只有有意修改游戏规则时才同步修改这里
+ */
+
+#ifndef REFERENCE_ENGINE_H
+#define REFERENCE_ENGINE_H
+
+#include "FixedPoint.h"
+#include "ObstacleSchedule.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class BasicReferenceEngine
+ * @brief 冻结的参考引擎
+ * @tparam Num 模拟数值类型（float或Fixed16，与被对照的引擎一致）
+ * @details 每帧先调用press（可选，对应handleKey），再调用step（对应一次非结束状态下的DinoGame::update）
+ */
+template <class Num>
+class BasicReferenceEngine {
+public:
+    /**
+     * @struct Body
+     * @brief 一个障碍物
+     */
+    struct Body {
+        ObstacleKind kind;
+        Num x, y, width, height;
+        int animationCounter;       // 出生以来的帧数（只有飞鸟计数）
+        int wing;                   // 飞鸟翅膀位置（0或1）
+    };
+
+private:
+    uint64_t seed;
+    Num dinoY, dinoVelocityY;
+    bool jumping, ducking;
+    std::vector<Body> obstacles;    // 按出生顺序排列
+    int score;
+    int gameSpeed;
+    int frameCount;
+    bool gameOver;
+    bool night;
+
+    void dinoJump();
+    void dinoDuck();
+    void dinoStand();
+    bool collides(const Body& body) const;
+
+public:
+    BasicReferenceEngine();
+
+    /**
+     * @brief 以指定种子开始新的一局（对应DinoGame::initialize）
+     */
+    void reset(uint64_t seed);
+
+    /**
+     * @brief 处理一次按键（PlayerInput）
+     */
+    void press(int input);
+
+    /**
+     * @brief 推进一帧；已经结束时不做任何事
+     */
+    void step();
+
+    /**
+     * @brief 第frame帧是否生成障碍物（与ObstacleSchedule使用相同的哈希规则，但逐帧直接计算）
+     */
+    static bool spawnAt(uint64_t seed, int frame, ScheduledSpawn& spawn);
+
+    uint64_t getSeed() const { return seed; }
+    Num getDinoX() const { return Num(50); }
+    Num getDinoY() const { return dinoY; }
+    Num getDinoVelocityY() const { return dinoVelocityY; }
+    Num getDinoWidth() const { return Num(40); }
+    bool getIsJumping() const { return jumping; }
+    bool getIsDucking() const { return ducking; }
+    const std::vector<Body>& getObstacles() const { return obstacles; }
+    int getScore() const { return score; }
+    int getGameSpeed() const { return gameSpeed; }
+    int getFrameCount() const { return frameCount; }
+    bool getIsGameOver() const { return gameOver; }
+    bool getIsNightMode() const { return night; }
+};
+
+typedef BasicReferenceEngine<DinoReal> ReferenceEngine;
+
+#endif // REFERENCE_ENGINE_H
@@ -0,0 +1,342 @@
+/**
+ * @file ServerMain.cpp
+ * @brief 多会话服务器主程序
+ * @details 启动SessionServer；可以同时在进程内启动一组模拟客户端（机器人）连接它，
+ *          运行指定时长后输出服务器的每核会话数、批次延迟、每帧字节数和客户端的解码校验结果
+ *
+ * 用法：dino_server [--socket 路径] [--workers N] [--tick-hz N] [--keyframe N] [--duration 秒]
+ *                   [--bots N] [--connect 路径]
+ *   不带--bots时一直运行到Ctrl+C
+ *   --connect 只运行机器人，连接已在运行的服务器
+ */
+
+#include "SessionServer.h"
+#include "MemoryTracking.h"
+#include "OptimizedDinoGame.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::atomic<bool> interrupted(false);
+
+void onSignal(int) {
+    interrupted = true;
+}
+
+/**
+ * @brief 把打开文件数的软限制提高到硬限制（每个会话一个套接字，机器人在进程内时再加一个）
+ */
+void raiseFileLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+/**
+ * @brief 进程的常驻内存（字节）
+ */
+long long residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    long long pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * @class BotSwarm
+ * @brief 一组模拟客户端，共用一个线程和一个epoll
+ * @details 每个机器人按收到的状态决定按键：障碍物接近时跳跃（会下蹲躲过的高处飞鸟不理会），
+ *          结束画面可以重启时按跳跃开始新的一局
+ */
+class BotSwarm {
+private:
+    struct Bot {
+        int fd = -1;
+        WireDecoder decoder;
+        WireState state;
+        long long messages = 0;
+        uint32_t answeredTick = UINT32_MAX;     // 已经按过键的帧，避免同一帧重复发送
+        uint32_t answeredEpisode = UINT32_MAX;
+    };
+
+    std::vector<Bot> bots;
+    int epollFd = -1;
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+public:
+    long long connected = 0;
+    long long bytesReceived = 0;
+    long long messages = 0;
+    long long decodeErrors = 0;
+    long long disconnects = 0;
+    long long inputsSent = 0;
+    long long restarts = 0;
+    long long keyframesChecked = 0;
+    long long keyframeMismatches = 0;
+
+    ~BotSwarm() { stop(); }
+
+    bool start(const std::string& path, int count) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) return false;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) return false;
+
+        bots.resize(count);
+        for (int i = 0; i < count; i++) {
+            Bot& bot = bots[i];
+            bot.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (bot.fd < 0 || connect(bot.fd, (sockaddr*)&address, sizeof(address)) != 0) {
+                std::cerr << "bot " << i << ": cannot connect to " << path << ": " << std::strerror(errno)
+                          << std::endl;
+                if (bot.fd >= 0) close(bot.fd);
+                bot.fd = -1;
+                bots.resize(i);
+                break;
+            }
+            uint64_t seed = (uint64_t)i + 1;
+            uint8_t hello[WIRE_HELLO_BYTES] = {WIRE_HELLO};
+            for (int k = 0; k < 8; k++) {
+                hello[1 + k] = (uint8_t)(seed >> (8 * k));
+            }
+            send(bot.fd, hello, sizeof(hello), MSG_NOSIGNAL);
+            int flags = fcntl(bot.fd, F_GETFL);
+            fcntl(bot.fd, F_SETFL, flags | O_NONBLOCK);
+            connected++;
+        }
+        for (Bot& bot : bots) {
+            epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.ptr = &bot;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, bot.fd, &ev);
+        }
+        running = true;
+        thread = std::thread(&BotSwarm::run, this);
+        return !bots.empty();
+    }
+
+    void stop() {
+        if (running.exchange(false)) {
+            thread.join();
+        }
+        for (Bot& bot : bots) {
+            if (bot.fd >= 0) close(bot.fd);
+            bot.fd = -1;
+            keyframesChecked += bot.decoder.keyframesChecked;
+            keyframeMismatches += bot.decoder.keyframeMismatches;
+            bot.decoder.keyframesChecked = bot.decoder.keyframeMismatches = 0;
+        }
+        if (epollFd >= 0) close(epollFd);
+        epollFd = -1;
+    }
+
+    void report(std::ostream& out) const {
+        out << "bots: " << connected << " connected, " << disconnects << " disconnected, " << messages
+            << " messages, " << bytesReceived << " bytes, " << inputsSent << " inputs, " << restarts
+            << " restarts\n"
+            << "  decode errors " << decodeErrors << ", keyframes checked against client prediction "
+            << keyframesChecked << ", mismatches " << keyframeMismatches << '\n';
+    }
+
+private:
+    /**
+     * @brief 按当前状态决定按键
+     */
+    uint8_t decide(const WireState& state) const {
+        if (state.flags & WIRE_GAME_OVER) {
+            return (state.flags & WIRE_CAN_RESTART) ? INPUT_JUMP_KEY : INPUT_NONE;
+        }
+        if (state.flags & WIRE_JUMPING) return INPUT_NONE;
+        const float dinoRight = 50 + 44;
+        for (const WireObstacle& o : state.obstacles) {
+            int bottom = o.y + o.height;
+            if (o.x + o.width < 50 || bottom <= 280) continue;     // 已经越过，或者从头顶飞过
+            float gap = o.x - dinoRight;
+            float reach = wireStep(state.speed) * 8;
+            if (gap > 0 && gap < reach) return INPUT_JUMP_KEY;
+        }
+        return INPUT_NONE;
+    }
+
+    void run() {
+        epoll_event events[256];
+        uint8_t buffer[4096];
+        while (running.load(std::memory_order_relaxed)) {
+            int n = epoll_wait(epollFd, events, 256, 50);
+            for (int i = 0; i < n; i++) {
+                Bot& bot = *static_cast<Bot*>(events[i].data.ptr);
+                if (bot.fd < 0) continue;
+                for (;;) {
+                    ssize_t got = recv(bot.fd, buffer, sizeof(buffer), 0);
+                    if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                    if (got < 0 && errno == EINTR) continue;
+                    if (got <= 0) {
+                        epoll_ctl(epollFd, EPOLL_CTL_DEL, bot.fd, nullptr);
+                        close(bot.fd);
+                        bot.fd = -1;
+                        disconnects++;
+                        break;
+                    }
+                    bytesReceived += got;
+                    long long before = bot.messages;
+                    if (!bot.decoder.feed(buffer, (size_t)got, bot.state, bot.messages)) {
+                        decodeErrors++;
+                    }
+                    messages += bot.messages - before;
+                }
+                if (bot.fd < 0 || bot.messages == 0) continue;
+                if (bot.state.tick == bot.answeredTick && bot.state.episode == bot.answeredEpisode) continue;
+                uint8_t key = decide(bot.state);
+                if (key == INPUT_NONE) continue;
+                if (send(bot.fd, &key, 1, MSG_NOSIGNAL) == 1) {
+                    inputsSent++;
+                    restarts += (bot.state.flags & WIRE_GAME_OVER) != 0;
+                }
+                bot.answeredTick = bot.state.tick;
+                bot.answeredEpisode = bot.state.episode;
+            }
+        }
+    }
+};
+
+}  // namespace
+
+/**
+ * @brief 服务器主入口
+ * @return 参数错误、启动失败或机器人发现解码错误返回1，否则返回0
+ */
+int main(int argc, char** argv) {
+    ServerConfig config;
+    double duration = 10;
+    int botCount = 0;
+    std::string connectPath;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::cerr << "missing value for " << arg << std::endl;
+            return 1;
+        }
+        if (std::strcmp(arg, "--socket") == 0) {
+            config.socketPath = value;
+        } else if (std::strcmp(arg, "--workers") == 0) {
+            config.workers = std::atoi(value);
+        } else if (std::strcmp(arg, "--tick-hz") == 0) {
+            config.tickHz = std::atoi(value);
+        } else if (std::strcmp(arg, "--keyframe") == 0) {
+            config.keyframeInterval = std::atoi(value);
+        } else if (std::strcmp(arg, "--duration") == 0) {
+            duration = std::atof(value);
+        } else if (std::strcmp(arg, "--bots") == 0) {
+            botCount = std::atoi(value);
+        } else if (std::strcmp(arg, "--connect") == 0) {
+            connectPath = value;
+        } else {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return 1;
+        }
+        i++;
+    }
+    if (config.workers <= 0 || config.tickHz <= 0 || config.keyframeInterval <= 0) {
+        std::cerr << "--workers, --tick-hz and --keyframe must be positive" << std::endl;
+        return 1;
+    }
+    if (!connectPath.empty() && botCount <= 0) {
+        std::cerr << "--connect requires --bots" << std::endl;
+        return 1;
+    }
+
+    raiseFileLimit();
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    auto waitFor = [&](double seconds) {
+        auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+        while (!interrupted && std::chrono::steady_clock::now() < end) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    };
+
+    // 只运行机器人
+    if (!connectPath.empty()) {
+        BotSwarm swarm;
+        if (!swarm.start(connectPath, botCount)) {
+            std::cerr << "cannot connect to " << connectPath << std::endl;
+            return 1;
+        }
+        waitFor(duration);
+        swarm.stop();
+        swarm.report(std::cout);
+        return swarm.decodeErrors > 0 || swarm.keyframeMismatches > 0 ? 1 : 0;
+    }
+
+    SessionServer server;
+    long long residentBefore = residentBytes();
+    AllocationCounts heapBefore = heapAllocationCounts();
+    if (!server.start(config)) {
+        std::cerr << "cannot listen on " << config.socketPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "listening on " << config.socketPath << " with " << config.workers << " workers at "
+              << config.tickHz << " Hz" << std::endl;
+
+    if (botCount <= 0) {
+        while (!interrupted) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        server.stop();
+        server.report(std::cout);
+        return 0;
+    }
+
+    BotSwarm swarm;
+    if (!swarm.start(config.socketPath, botCount)) {
+        server.stop();
+        return 1;
+    }
+    // 所有会话都已建立并推进几帧之后取内存，包含每个会话第一段障碍物计划的缓冲区
+    auto warmStart = std::chrono::steady_clock::now();
+    while (!interrupted && server.getSessionCount() < swarm.connected &&
+           std::chrono::steady_clock::now() - warmStart < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    waitFor(0.2);
+    long long sessions = server.getSessionCount();
+    AllocationCounts heapAfter = heapAllocationCounts();
+    long long residentAfter = residentBytes();
+    waitFor(std::max(0.0, duration - std::chrono::duration<double>(std::chrono::steady_clock::now() - warmStart).count()));
+
+    swarm.stop();
+    server.stop();
+    server.report(std::cout);
+    if (sessions > 0) {
+        std::cout << "  memory: " << (heapAfter.bytes - heapBefore.bytes) / sessions
+                  << " heap bytes allocated per session (server and bots), resident "
+                  << (residentAfter - residentBefore) / sessions << " bytes per session\n";
+    }
+    swarm.report(std::cout);
+    return swarm.decodeErrors > 0 || swarm.keyframeMismatches > 0 ? 1 : 0;
+}
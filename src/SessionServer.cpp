@@ -0,0 +1,741 @@
+/**
+ * @file SessionServer.cpp
+ * @brief 多会话游戏服务器实现文件
+ * @details 线上格式的编解码、工作线程的事件循环、成批推进和发送
+ */
+
+#include "SessionServer.h"
+#include "OptimizedDinoGame.h"
+#include "ObstacleSchedule.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// ==================== 线上格式 ====================
+
+void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+void putI16(std::vector<uint8_t>& out, int16_t value) {
+    out.push_back((uint8_t)((uint16_t)value & 0xFF));
+    out.push_back((uint8_t)((uint16_t)value >> 8));
+}
+
+void putObstacle(std::vector<uint8_t>& out, const WireObstacle& o) {
+    out.push_back(o.kind);
+    putI16(out, (int16_t)std::lround(o.x));
+    putI16(out, o.y);
+    out.push_back(o.width);
+    out.push_back(o.height);
+}
+
+bool isFresh(const WireObstacle& o) {
+    return o.x > WIRE_SPAWN_X - 10;
+}
+
+/**
+ * @class WireReader
+ * @brief 带边界检查的读取；数据不足时置incomplete
+ */
+struct WireReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    bool incomplete = false;
+
+    WireReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    uint8_t u8() {
+        if (pos >= size) {
+            incomplete = true;
+            return 0;
+        }
+        return data[pos++];
+    }
+
+    int16_t i16() {
+        uint16_t lo = u8();
+        uint16_t hi = u8();
+        return (int16_t)(lo | (hi << 8));
+    }
+
+    uint32_t varint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35 && !incomplete; shift += 7) {
+            uint8_t b = u8();
+            value |= (uint32_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+        }
+        return value;
+    }
+
+    WireObstacle obstacle() {
+        WireObstacle o;
+        o.kind = u8();
+        o.x = i16();
+        o.y = i16();
+        o.width = u8();
+        o.height = u8();
+        return o;
+    }
+};
+
+/**
+ * @brief 按客户端的规则推进一帧：结束画面中不动；否则清理x<-50的障碍物，再按上一帧的速度等级移动
+ */
+void advanceObstacles(WireState& state) {
+    if (state.flags & WIRE_GAME_OVER) return;
+    state.tick++;
+    const float step = wireStep(state.speed);
+    state.obstacles.erase(std::remove_if(state.obstacles.begin(), state.obstacles.end(),
+                                         [](const WireObstacle& o) { return o.x < -50; }),
+                          state.obstacles.end());
+    for (WireObstacle& o : state.obstacles) {
+        o.x -= step;
+    }
+}
+
+bool sameObstacle(const WireObstacle& a, const WireObstacle& b) {
+    return a.kind == b.kind && std::fabs(a.x - b.x) <= 1 && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+bool obstacleOrder(const WireObstacle& a, const WireObstacle& b) {
+    return a.kind != b.kind ? a.kind < b.kind : a.x < b.x;
+}
+
+uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+double threadCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+}  // namespace
+
+float wireStep(int speed) {
+    return 5.0f + (float)speed * 0.15f;
+}
+
+void captureWireState(const DinoGame& game, WireState& state) {
+    const Dinosaur& dino = game.getPlayer();
+    state.episode = game.getEpisode();
+    state.tick = (uint32_t)game.getFrameCount();
+    state.score = game.getCurrentScore();
+    state.speed = (uint8_t)game.getGameSpeed();
+    state.flags = (game.getIsGameOver() ? WIRE_GAME_OVER : 0) | (game.getIsNightMode() ? WIRE_NIGHT : 0) |
+                  (dino.getIsJumping() ? WIRE_JUMPING : 0) | (dino.getIsDucking() ? WIRE_DUCKING : 0) |
+                  (game.canRestart() ? WIRE_CAN_RESTART : 0);
+    state.dinoY = (int16_t)std::lround(toFloat(dino.getY()));
+    state.obstacles.clear();
+    game.getObstacles().forEach([&](const ObstacleView& view) {
+        WireObstacle o;
+        o.kind = (uint8_t)view.kind;
+        o.x = view.x;
+        o.y = (int16_t)std::lround(view.y);
+        o.width = (uint8_t)std::lround(view.width);
+        o.height = (uint8_t)std::lround(view.height);
+        state.obstacles.push_back(o);
+    });
+}
+
+void encodeKeyframe(const WireState& state, std::vector<uint8_t>& out) {
+    out.push_back(WIRE_KEYFRAME);
+    putVarint(out, state.episode);
+    putVarint(out, state.tick);
+    putVarint(out, (uint32_t)state.score);
+    out.push_back(state.speed);
+    out.push_back(state.flags);
+    putI16(out, state.dinoY);
+    out.push_back((uint8_t)std::min<size_t>(state.obstacles.size(), 255));
+    for (size_t i = 0; i < state.obstacles.size() && i < 255; i++) {
+        putObstacle(out, state.obstacles[i]);
+    }
+}
+
+/**
+ * @details 新生成的障碍物是x仍在生成带内的那些（最短生成间隔20帧，带内最多一个）；
+ *          其余障碍物由客户端自行推进，不占线上字节
+ */
+void encodeDelta(WireState& previous, const WireState& current, std::vector<uint8_t>& out) {
+    const size_t start = out.size();
+    out.push_back(WIRE_DELTA);
+    out.push_back(0);
+    uint8_t mask = 0;
+    if (current.score != previous.score) {
+        mask |= WIRE_SCORE;
+        putVarint(out, zigzag(current.score - previous.score));
+    }
+    if (current.speed != previous.speed) {
+        mask |= WIRE_SPEED;
+        out.push_back(current.speed);
+    }
+    if (current.flags != previous.flags) {
+        mask |= WIRE_FLAGS;
+        out.push_back(current.flags);
+    }
+    if (current.dinoY != previous.dinoY) {
+        mask |= WIRE_DINO_Y;
+        putI16(out, current.dinoY);
+    }
+    if (!(previous.flags & WIRE_GAME_OVER)) {
+        size_t countAt = out.size();
+        uint8_t count = 0;
+        out.push_back(0);
+        for (const WireObstacle& o : current.obstacles) {
+            if (isFresh(o) && count < 255) {
+                putObstacle(out, o);
+                count++;
+            }
+        }
+        if (count > 0) {
+            mask |= WIRE_SPAWNS;
+            out[countAt] = count;
+        } else {
+            out.pop_back();
+        }
+    }
+    out[start + 1] = mask;
+
+    previous.episode = current.episode;
+    previous.tick = current.tick;
+    previous.score = current.score;
+    previous.speed = current.speed;
+    previous.flags = current.flags;
+    previous.dinoY = current.dinoY;
+}
+
+// ==================== WireDecoder类实现 ====================
+
+/**
+ * @details 每条消息先完整解析再应用，数据不足时留到下一次输入。
+ *          与上一帧连续的关键帧会与客户端推算的障碍物比较（允许1像素误差），用来发现增量协议的漂移
+ */
+bool WireDecoder::feed(const uint8_t* data, size_t size, WireState& state, long long& messages) {
+    pending.insert(pending.end(), data, data + size);
+    size_t consumed = 0;
+    bool ok = true;
+
+    while (consumed < pending.size()) {
+        WireReader in(pending.data() + consumed, pending.size() - consumed);
+        uint8_t type = in.u8();
+        if (type == WIRE_KEYFRAME) {
+            WireState next;
+            next.episode = in.varint();
+            next.tick = in.varint();
+            next.score = (int32_t)in.varint();
+            next.speed = in.u8();
+            next.flags = in.u8();
+            next.dinoY = in.i16();
+            uint8_t count = in.u8();
+            for (int i = 0; i < count && !in.incomplete; i++) {
+                next.obstacles.push_back(in.obstacle());
+            }
+            if (in.incomplete) break;
+
+            WireState predicted = state;
+            advanceObstacles(predicted);
+            if (messages > 0 && next.episode == state.episode && next.tick == predicted.tick) {
+                std::vector<WireObstacle> expected, actual;
+                // 线上x取整后，-50附近的障碍物在客户端可能早或晚一帧被清理，不参与比较
+                for (const WireObstacle& o : predicted.obstacles) {
+                    if (!isFresh(o) && o.x >= -45) expected.push_back(o);
+                }
+                for (const WireObstacle& o : next.obstacles) {
+                    if (!isFresh(o) && o.x >= -45) actual.push_back(o);
+                }
+                std::sort(expected.begin(), expected.end(), obstacleOrder);
+                std::sort(actual.begin(), actual.end(), obstacleOrder);
+                bool match = expected.size() == actual.size() &&
+                             std::equal(expected.begin(), expected.end(), actual.begin(), sameObstacle) &&
+                             next.score == state.score + ((state.flags & WIRE_GAME_OVER) ? 0 : 1);
+                keyframesChecked++;
+                keyframeMismatches += !match;
+            }
+            state = std::move(next);
+        } else if (type == WIRE_DELTA) {
+            uint8_t mask = in.u8();
+            int32_t scoreDelta = (mask & WIRE_SCORE) ? unzigzag(in.varint()) : 0;
+            uint8_t speed = (mask & WIRE_SPEED) ? in.u8() : state.speed;
+            uint8_t flags = (mask & WIRE_FLAGS) ? in.u8() : state.flags;
+            int16_t dinoY = (mask & WIRE_DINO_Y) ? in.i16() : state.dinoY;
+            WireObstacle spawns[4];
+            uint8_t count = (mask & WIRE_SPAWNS) ? in.u8() : 0;
+            for (int i = 0; i < count && !in.incomplete; i++) {
+                WireObstacle o = in.obstacle();
+                if (i < 4) spawns[i] = o;
+            }
+            if (in.incomplete) break;
+
+            advanceObstacles(state);
+            state.score += scoreDelta;
+            state.speed = speed;
+            state.flags = flags;
+            state.dinoY = dinoY;
+            state.obstacles.insert(state.obstacles.end(), spawns, spawns + std::min<int>(count, 4));
+        } else {
+            ok = false;
+            consumed = pending.size();
+            break;
+        }
+        consumed += in.pos;
+        messages++;
+    }
+    pending.erase(pending.begin(), pending.begin() + consumed);
+    return ok;
+}
+
+// ==================== 工作线程 ====================
+
+namespace {
+
+/**
+ * @struct Session
+ * @brief 一个连接及其对局
+ */
+struct Session {
+    int fd = -1;
+    size_t index = 0;                   // 在工作线程会话表中的位置
+    DinoGame game;
+    uint64_t seed = 0;
+    uint8_t hello[WIRE_HELLO_BYTES];
+    size_t helloSize = 0;
+    bool ready = false;                 // 已收到种子
+    uint8_t inputs[8];                  // 本帧收到的按键
+    int inputCount = 0;
+    WireState sent;                     // 客户端已有的标量字段
+    int sinceKeyframe = 0;
+    bool needKeyframe = true;
+    std::vector<uint8_t> out;           // 待发送的字节（从outOffset开始）
+    size_t outOffset = 0;
+    bool watchingWrite = false;
+    bool closed = false;
+
+    explicit Session(size_t arenaCapacity) : game(arenaCapacity) {}
+};
+
+}  // namespace
+
+/**
+ * @struct SessionServer::Worker
+ * @brief 一个工作线程的全部状态（只由该线程访问，stop之后可读）
+ */
+struct SessionServer::Worker {
+    int epollFd = -1;
+    int timerFd = -1;
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::atomic<long long> sessionCount{0};
+    WireState scratch;                  // 本帧的状态，所有会话共用
+    ServerStats stats;
+    std::vector<uint32_t> latency;      // 批次延迟直方图
+    double maxTickMs = 0;
+};
+
+namespace {
+
+const int TIMER_TAG = 0;                // epoll中定时器的标记（监听套接字的data.ptr为nullptr）
+const size_t COMPACT_BYTES = 4096;      // 发送缓冲区中已发送的前缀至少这么长才挪动
+
+}  // namespace
+
+SessionServer::SessionServer() : listenFd(-1), running(false) {}
+
+SessionServer::~SessionServer() {
+    stop();
+    for (Worker* worker : workers) {
+        delete worker;
+    }
+}
+
+bool SessionServer::start(const ServerConfig& newConfig) {
+    stop();
+    for (Worker* worker : workers) {
+        delete worker;
+    }
+    workers.clear();
+    config = newConfig;
+    config.workers = std::max(1, config.workers);
+    config.tickHz = std::max(1, config.tickHz);
+    config.keyframeInterval = std::max(1, config.keyframeInterval);
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (config.socketPath.size() >= sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path, config.socketPath.c_str(), config.socketPath.size() + 1);
+    unlink(config.socketPath.c_str());
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) return false;
+    if (bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd, 4096) != 0) {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    for (int i = 0; i < config.workers; i++) {
+        Worker* worker = new Worker();
+        workers.push_back(worker);
+        worker->latency.assign(LATENCY_BUCKETS, 0);
+        worker->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        worker->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        epoll_event listenEvent = {};
+        listenEvent.events = EPOLLIN | EPOLLEXCLUSIVE;
+        listenEvent.data.ptr = nullptr;
+        epoll_event timerEvent = {};
+        timerEvent.events = EPOLLIN;
+        timerEvent.data.ptr = (void*)&TIMER_TAG;
+        if (worker->epollFd < 0 || worker->timerFd < 0 ||
+            epoll_ctl(worker->epollFd, EPOLL_CTL_ADD, listenFd, &listenEvent) != 0 ||
+            epoll_ctl(worker->epollFd, EPOLL_CTL_ADD, worker->timerFd, &timerEvent) != 0) {
+            running = true;     // 让stop清理已创建的部分
+            stop();
+            return false;
+        }
+    }
+
+    running = true;
+    for (Worker* worker : workers) {
+        threads.emplace_back(&SessionServer::runWorker, this, std::ref(*worker));
+    }
+    return true;
+}
+
+void SessionServer::stop() {
+    if (!running.exchange(false)) return;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    for (Worker* worker : workers) {
+        for (auto& session : worker->sessions) {
+            if (!session->closed) {
+                close(session->fd);
+                worker->stats.sessionsClosed++;
+            }
+        }
+        worker->sessions.clear();
+        worker->sessionCount = 0;
+        if (worker->epollFd >= 0) close(worker->epollFd);
+        if (worker->timerFd >= 0) close(worker->timerFd);
+        worker->epollFd = worker->timerFd = -1;
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(config.socketPath.c_str());
+        listenFd = -1;
+    }
+}
+
+/**
+ * @details 事件循环：接受连接、读取按键、续发积压的字节；定时器每到一个节拍，
+ *          先推进本线程的全部会话，再逐个编码并发送，最后记录从节拍时刻到发送完毕的批次延迟。
+ *          关闭的会话在一轮事件处理完之后才从会话表中移除
+ */
+void SessionServer::runWorker(Worker& worker) {
+    const double cpuStart = threadCpuSeconds();
+    const uint64_t wallStart = monotonicNs();
+    const uint64_t periodNs = 1000000000ULL / config.tickHz;
+    uint64_t nextTickNs = wallStart + periodNs;
+    epoll_event events[256];
+
+    // 定时器按绝对时间对齐，批次延迟与节拍时刻用同一个时钟
+    itimerspec schedule = {};
+    schedule.it_interval.tv_sec = periodNs / 1000000000ULL;
+    schedule.it_interval.tv_nsec = periodNs % 1000000000ULL;
+    schedule.it_value.tv_sec = nextTickNs / 1000000000ULL;
+    schedule.it_value.tv_nsec = nextTickNs % 1000000000ULL;
+    timerfd_settime(worker.timerFd, TFD_TIMER_ABSTIME, &schedule, nullptr);
+
+    auto closeSession = [&](Session& s) {
+        if (s.closed) return;
+        epoll_ctl(worker.epollFd, EPOLL_CTL_DEL, s.fd, nullptr);
+        close(s.fd);
+        s.closed = true;
+        worker.stats.sessionsClosed++;
+        worker.sessionCount--;
+    };
+
+    auto watchWrite = [&](Session& s, bool watch) {
+        if (s.watchingWrite == watch) return;
+        epoll_event ev = {};
+        uint32_t mask = EPOLLIN;
+        if (watch) mask |= EPOLLOUT;
+        ev.events = mask;
+        ev.data.ptr = &s;
+        epoll_ctl(worker.epollFd, EPOLL_CTL_MOD, s.fd, &ev);
+        s.watchingWrite = watch;
+    };
+
+    auto flush = [&](Session& s) {
+        while (s.outOffset < s.out.size()) {
+            ssize_t n = send(s.fd, s.out.data() + s.outOffset, s.out.size() - s.outOffset, MSG_NOSIGNAL);
+            if (n > 0) {
+                s.outOffset += (size_t)n;
+                worker.stats.bytesSent += n;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                closeSession(s);
+                return;
+            }
+        }
+        if (s.outOffset == s.out.size()) {
+            s.out.clear();
+            s.outOffset = 0;
+            watchWrite(s, false);
+        } else {
+            // 一直发不完的慢连接不会走到上面的清空：已发送的前缀超过一半时挪掉，缓冲区不超过积压的两倍
+            if (s.outOffset >= COMPACT_BYTES && s.outOffset * 2 >= s.out.size()) {
+                s.out.erase(s.out.begin(), s.out.begin() + (std::ptrdiff_t)s.outOffset);
+                s.outOffset = 0;
+            }
+            watchWrite(s, true);
+        }
+    };
+
+    auto receive = [&](Session& s) {
+        uint8_t buffer[256];
+        for (;;) {
+            ssize_t n = recv(s.fd, buffer, sizeof(buffer), 0);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                closeSession(s);
+                return;
+            }
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            for (ssize_t i = 0; i < n; i++) {
+                uint8_t b = buffer[i];
+                if (!s.ready) {
+                    s.hello[s.helloSize++] = b;
+                    if (s.helloSize < WIRE_HELLO_BYTES) continue;
+                    if (s.hello[0] != WIRE_HELLO) {
+                        worker.stats.protocolErrors++;
+                        closeSession(s);
+                        return;
+                    }
+                    s.seed = 0;
+                    for (int k = 8; k >= 1; k--) {
+                        s.seed = (s.seed << 8) | s.hello[k];
+                    }
+                    s.game.initialize(s.seed);
+                    s.ready = true;
+                    s.needKeyframe = true;
+                } else if (b == INPUT_JUMP_KEY || b == INPUT_DUCK_KEY) {
+                    worker.stats.inputs++;
+                    if (s.inputCount < 8) s.inputs[s.inputCount++] = b;
+                } else {
+                    worker.stats.protocolErrors++;
+                    closeSession(s);
+                    return;
+                }
+            }
+        }
+    };
+
+    auto acceptAll = [&]() {
+        for (int i = 0; i < 64; i++) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            std::unique_ptr<Session> s(new Session(config.arenaCapacity));
+            s->fd = fd;
+            s->index = worker.sessions.size();
+            s->out.reserve(512);
+            epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.ptr = s.get();
+            if (epoll_ctl(worker.epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                close(fd);
+                continue;
+            }
+            worker.sessions.push_back(std::move(s));
+            worker.stats.sessionsOpened++;
+            worker.sessionCount++;
+            worker.stats.peakSessions = std::max(worker.stats.peakSessions, (long long)worker.sessions.size());
+        }
+    };
+
+    auto tick = [&](uint64_t scheduledNs) {
+        for (auto& ptr : worker.sessions) {
+            Session& s = *ptr;
+            if (s.closed || !s.ready) continue;
+            for (int i = 0; i < s.inputCount; i++) {
+                if (s.game.getIsGameOver()) {
+                    if (s.game.canRestart()) {
+                        // 相邻的连接种子之间不能共享赛道，每局的种子由连接种子和局号散列得到
+                        const uint64_t nextEpisode = (uint64_t)s.game.getEpisode() + 1;
+                        s.game.initialize(splitmix64(s.seed ^ splitmix64(nextEpisode)));
+                    }
+                } else {
+                    s.game.handleKey(s.inputs[i] == INPUT_JUMP_KEY ? ' ' : 's');
+                }
+            }
+            s.inputCount = 0;
+            s.game.update();
+            worker.stats.sessionTicks++;
+        }
+
+        for (auto& ptr : worker.sessions) {
+            Session& s = *ptr;
+            if (s.closed || !s.ready) continue;
+            if (s.out.size() - s.outOffset > config.maxPendingBytes) {
+                worker.stats.skippedDeltas++;
+                s.needKeyframe = true;
+                continue;
+            }
+            captureWireState(s.game, worker.scratch);
+            if (s.needKeyframe || worker.scratch.episode != s.sent.episode || ++s.sinceKeyframe >= config.keyframeInterval) {
+                encodeKeyframe(worker.scratch, s.out);
+                s.sent.episode = worker.scratch.episode;
+                s.sent.score = worker.scratch.score;
+                s.sent.speed = worker.scratch.speed;
+                s.sent.flags = worker.scratch.flags;
+                s.sent.dinoY = worker.scratch.dinoY;
+                s.sinceKeyframe = 0;
+                s.needKeyframe = false;
+                worker.stats.keyframes++;
+            } else {
+                encodeDelta(s.sent, worker.scratch, s.out);
+                worker.stats.deltas++;
+            }
+            flush(s);
+        }
+
+        worker.stats.ticks++;
+        uint64_t now = monotonicNs();
+        double ms = now > scheduledNs ? (now - scheduledNs) / 1e6 : 0;
+        int bucket = std::min(LATENCY_BUCKETS - 1, (int)(ms * 100));
+        worker.latency[bucket]++;
+        worker.maxTickMs = std::max(worker.maxTickMs, ms);
+    };
+
+    while (running.load(std::memory_order_relaxed)) {
+        int n = epoll_wait(worker.epollFd, events, 256, 100);
+        for (int i = 0; i < n; i++) {
+            void* tag = events[i].data.ptr;
+            if (tag == nullptr) {
+                acceptAll();
+            } else if (tag == &TIMER_TAG) {
+                uint64_t expirations = 0;
+                if (read(worker.timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) continue;
+                // 错过的节拍不补推，批次延迟从最近一个节拍算起
+                nextTickNs += periodNs * (expirations > 0 ? expirations - 1 : 0);
+                tick(nextTickNs);
+                nextTickNs += periodNs;
+            } else {
+                Session& s = *static_cast<Session*>(tag);
+                if (s.closed) continue;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) receive(s);
+                if (!s.closed && (events[i].events & EPOLLOUT)) flush(s);
+            }
+        }
+
+        // 移除本轮关闭的会话（与末尾交换）
+        for (size_t i = 0; i < worker.sessions.size();) {
+            if (!worker.sessions[i]->closed) {
+                i++;
+                continue;
+            }
+            std::swap(worker.sessions[i], worker.sessions.back());
+            worker.sessions[i]->index = i;
+            worker.sessions.pop_back();
+        }
+    }
+
+    worker.stats.cpuSeconds = threadCpuSeconds() - cpuStart;
+    worker.stats.wallSeconds = (monotonicNs() - wallStart) * 1e-9;
+}
+
+long long SessionServer::getSessionCount() const {
+    long long count = 0;
+    for (const Worker* worker : workers) {
+        count += worker->sessionCount.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+ServerStats SessionServer::getStats() const {
+    ServerStats total;
+    std::vector<uint64_t> histogram(LATENCY_BUCKETS, 0);
+    for (const Worker* worker : workers) {
+        const ServerStats& s = worker->stats;
+        total.sessionsOpened += s.sessionsOpened;
+        total.sessionsClosed += s.sessionsClosed;
+        total.peakSessions += s.peakSessions;
+        total.ticks += s.ticks;
+        total.sessionTicks += s.sessionTicks;
+        total.inputs += s.inputs;
+        total.keyframes += s.keyframes;
+        total.deltas += s.deltas;
+        total.skippedDeltas += s.skippedDeltas;
+        total.bytesSent += s.bytesSent;
+        total.protocolErrors += s.protocolErrors;
+        total.cpuSeconds += s.cpuSeconds;
+        total.wallSeconds = std::max(total.wallSeconds, s.wallSeconds);
+        total.maxTickMs = std::max(total.maxTickMs, worker->maxTickMs);
+        for (int i = 0; i < LATENCY_BUCKETS; i++) {
+            histogram[i] += worker->latency[i];
+        }
+    }
+
+    // 分位数取所在格的上沿
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS && total.ticks > 0; i++) {
+        uint64_t before = seen;
+        seen += histogram[i];
+        if (before < (uint64_t)total.ticks * 50 / 100 && seen >= (uint64_t)total.ticks * 50 / 100) {
+            total.p50TickMs = (i + 1) / 100.0;
+        }
+        if (before < (uint64_t)total.ticks * 99 / 100 && seen >= (uint64_t)total.ticks * 99 / 100) {
+            total.p99TickMs = (i + 1) / 100.0;
+        }
+    }
+    return total;
+}
+
+void SessionServer::report(std::ostream& out) const {
+    ServerStats s = getStats();
+    double cpuPerSessionTickUs = s.sessionTicks > 0 ? s.cpuSeconds / s.sessionTicks * 1e6 : 0;
+    double sessionsPerCore = cpuPerSessionTickUs > 0 ? 1e6 / (cpuPerSessionTickUs * config.tickHz) : 0;
+    double bytesPerTick = s.sessionTicks > 0 ? (double)s.bytesSent / s.sessionTicks : 0;
+    out << "server: " << config.workers << " workers at " << config.tickHz << " Hz, " << s.sessionsOpened
+        << " sessions opened (peak " << s.peakSessions << "), " << s.sessionsClosed << " closed\n"
+        << "  ticks: " << s.ticks << " batches, " << s.sessionTicks << " session ticks, batch latency p50 "
+        << s.p50TickMs << " ms, p99 " << s.p99TickMs << " ms, max " << s.maxTickMs << " ms\n"
+        << "  cpu: " << s.cpuSeconds << " s in " << s.wallSeconds << " s, " << cpuPerSessionTickUs
+        << " us per session tick, about " << (long long)sessionsPerCore << " sessions per core at "
+        << config.tickHz << " Hz\n"
+        << "  traffic: " << bytesPerTick << " bytes per session tick, " << s.keyframes << " keyframes, " << s.deltas
+        << " deltas, " << s.skippedDeltas << " skipped, " << s.inputs << " inputs, " << s.protocolErrors
+        << " protocol errors\n";
+}
@@ -0,0 +1,223 @@
+/**
+ * @file SessionServer.h
+ * @brief 多会话游戏服务器头文件
+ * @details 一个进程内同时运行大量相互独立的DinoGame会话，每个会话对应一个Unix域套接字连接和自己的种子。
+ *          客户端发送单字节的按键消息，服务器以权威状态逐帧推进，并回送紧凑的二进制增量。
+ *
+ *          每个工作线程有自己的epoll和会话表，共享监听套接字（EPOLLEXCLUSIVE，每个连接只唤醒一个线程）。
+ *          工作线程按固定节拍把本线程的全部会话成批推进：先应用各会话收到的按键并更新，再依次编码和发送。
+ *
+ *          协议（小端）：
+ *          - 客户端：连接后发送'H'和8字节种子；之后每个字节是一个按键（1跳跃，2下蹲），
+ *            结束画面的延迟过后按任意键开始新的一局（第一局用连接的种子，之后第n局用splitmix64(种子 ^ splitmix64(n))）
+ *          - 服务器：'K'关键帧携带完整状态，'D'增量只携带本帧变化的字段和新生成的障碍物，
+ *            客户端按速度等级自行移动和清理障碍物。连接建立、新的一局、每keyframeInterval帧
+ *            以及积压的增量被丢弃之后发送关键帧
+ */
+
+#ifndef SESSION_SERVER_H
+#define SESSION_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <thread>
+#include <vector>
+
+class DinoGame;
+
+/**
+ * @enum WireMessage
+ * @brief 消息类型字节
+ */
+enum WireMessage : uint8_t {
+    WIRE_HELLO = 'H',               // 客户端：'H' + 8字节种子
+    WIRE_KEYFRAME = 'K',            // 服务器：完整状态
+    WIRE_DELTA = 'D'                // 服务器：相对上一帧的变化
+};
+
+/**
+ * @enum WireDeltaField
+ * @brief 增量消息中的字段掩码
+ */
+enum WireDeltaField : uint8_t {
+    WIRE_SCORE = 1,                 // 分数差（zigzag变长整数）
+    WIRE_SPEED = 2,                 // 速度等级
+    WIRE_FLAGS = 4,                 // 状态标志
+    WIRE_DINO_Y = 8,                // 恐龙y（像素，int16）
+    WIRE_SPAWNS = 16                // 新生成的障碍物
+};
+
+/**
+ * @enum WireFlag
+ * @brief 状态标志位
+ */
+enum WireFlag : uint8_t {
+    WIRE_GAME_OVER = 1,
+    WIRE_NIGHT = 2,
+    WIRE_JUMPING = 4,
+    WIRE_DUCKING = 8,
+    WIRE_CAN_RESTART = 16
+};
+
+const size_t WIRE_HELLO_BYTES = 9;
+const int WIRE_SPAWN_X = 800;       // 障碍物生成时的x，本帧移动一次后仍在(WIRE_SPAWN_X-10, WIRE_SPAWN_X]内
+
+/**
+ * @struct WireObstacle
+ * @brief 线上的障碍物（x在线上为int16像素，客户端以float移动）
+ */
+struct WireObstacle {
+    uint8_t kind = 0;
+    float x = 0;
+    int16_t y = 0;
+    uint8_t width = 0, height = 0;
+};
+
+/**
+ * @struct WireState
+ * @brief 客户端可见的会话状态
+ */
+struct WireState {
+    uint32_t episode = 0;
+    uint32_t tick = 0;              // 本局的帧数
+    int32_t score = 0;
+    uint8_t speed = 0;
+    uint8_t flags = 0;
+    int16_t dinoY = 0;
+    std::vector<WireObstacle> obstacles;
+};
+
+/**
+ * @brief 从游戏取出线上状态（障碍物按种类、再按组件数组的顺序）
+ */
+void captureWireState(const DinoGame& game, WireState& state);
+
+/**
+ * @brief 追加一条关键帧消息
+ */
+void encodeKeyframe(const WireState& state, std::vector<uint8_t>& out);
+
+/**
+ * @brief 追加一条增量消息
+ * @param previous 客户端已有的标量字段（编码后更新为current的；障碍物由客户端推进，服务器不保存）
+ */
+void encodeDelta(WireState& previous, const WireState& current, std::vector<uint8_t>& out);
+
+/**
+ * @brief 障碍物一帧的位移（与ObstacleWorld的移动规则相同，以float计算）
+ */
+float wireStep(int speed);
+
+/**
+ * @class WireDecoder
+ * @brief 客户端的流式解码器，处理跨越多次读取的消息
+ */
+class WireDecoder {
+private:
+    std::vector<uint8_t> pending;
+
+public:
+    long long keyframesChecked = 0;     // 与上一帧连续、已和客户端推算结果比较过的关键帧
+    long long keyframeMismatches = 0;   // 其中障碍物或分数与推算不符的
+
+
+    /**
+     * @brief 输入收到的字节，依次应用完整的消息
+     * @param messages 累加应用的消息数
+     * @return 遇到无法识别的消息返回false
+     */
+    bool feed(const uint8_t* data, size_t size, WireState& state, long long& messages);
+};
+
+/**
+ * @struct ServerConfig
+ * @brief 服务器配置
+ */
+struct ServerConfig {
+    std::string socketPath = "/tmp/dino_server.sock";
+    int workers = 1;                // 工作线程数
+    int tickHz = 30;                // 每秒推进的帧数
+    int keyframeInterval = 90;      // 关键帧间隔（帧）
+    size_t arenaCapacity = 4096;    // 每个会话的竞技场缓冲区（字节）
+    size_t maxPendingBytes = 4096;  // 单个连接积压的发送字节超过此值时丢弃增量，待发完后补发关键帧
+};
+
+/**
+ * @struct ServerStats
+ * @brief 服务器统计（stop之后读取）
+ */
+struct ServerStats {
+    long long sessionsOpened = 0;
+    long long sessionsClosed = 0;
+    long long peakSessions = 0;
+    long long ticks = 0;                // 各工作线程的批次数之和
+    long long sessionTicks = 0;         // 推进的会话帧数
+    long long inputs = 0;               // 收到的按键
+    long long keyframes = 0;
+    long long deltas = 0;
+    long long skippedDeltas = 0;        // 因连接积压而未发送的增量
+    long long bytesSent = 0;
+    long long protocolErrors = 0;
+    double cpuSeconds = 0;              // 工作线程的CPU时间
+    double wallSeconds = 0;
+    double p50TickMs = 0;               // 批次延迟：从节拍时刻到本批全部发送完毕
+    double p99TickMs = 0;
+    double maxTickMs = 0;
+};
+
+/**
+ * @class SessionServer
+ * @brief 多会话服务器
+ */
+class SessionServer {
+public:
+    static const int LATENCY_BUCKETS = 10000;   // 批次延迟直方图（10微秒一格，最后一格为100毫秒以上）
+
+private:
+    struct Worker;
+
+    ServerConfig config;
+    int listenFd;
+    std::atomic<bool> running;
+    std::vector<Worker*> workers;
+    std::vector<std::thread> threads;
+
+    void runWorker(Worker& worker);
+
+public:
+    SessionServer();
+    ~SessionServer();
+
+    SessionServer(const SessionServer&) = delete;
+    SessionServer& operator=(const SessionServer&) = delete;
+
+    /**
+     * @brief 创建监听套接字并启动工作线程
+     * @return 套接字或epoll创建失败返回false
+     */
+    bool start(const ServerConfig& config);
+
+    /**
+     * @brief 停止工作线程，关闭所有连接并删除套接字文件
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 当前的会话数（各工作线程的近似值之和）
+     */
+    long long getSessionCount() const;
+
+    ServerStats getStats() const;
+
+    /**
+     * @brief 输出会话数、每核会话数、批次延迟和每帧每会话的字节数
+     */
+    void report(std::ostream& out) const;
+};
+
+#endif // SESSION_SERVER_H
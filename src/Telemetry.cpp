@@ -0,0 +1,241 @@
+/**
+ * @file Telemetry.cpp
+ * @brief 共享内存遥测实现文件
+ * @details 共享内存段的创建和映射、顺序锁快照和无锁事件环
+ */
+
+#include "Telemetry.h"
+#include <chrono>
+#include <cstring>
+#include <new>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "telemetry words must be lock-free to be shared across processes");
+static_assert((TelemetrySegment::EVENT_CAPACITY & (TelemetrySegment::EVENT_CAPACITY - 1)) == 0,
+              "event capacity must be a power of two");
+
+const char* const TELEMETRY_DEFAULT_NAME = "/dino_telemetry";
+
+namespace {
+
+/**
+ * @brief 把负载按8字节字写入原子数组（尾部不足一个字的部分补0）
+ */
+template <class T, size_t WORDS>
+void storeWords(std::atomic<uint64_t> (&dst)[WORDS], const T& value) {
+    uint64_t words[WORDS] = {};
+    std::memcpy(words, &value, sizeof(T));
+    for (size_t i = 0; i < WORDS; i++) {
+        dst[i].store(words[i], std::memory_order_relaxed);
+    }
+}
+
+template <class T, size_t WORDS>
+void loadWords(const std::atomic<uint64_t> (&src)[WORDS], T& value) {
+    uint64_t words[WORDS];
+    for (size_t i = 0; i < WORDS; i++) {
+        words[i] = src[i].load(std::memory_order_relaxed);
+    }
+    std::memcpy(&value, words, sizeof(T));
+}
+
+}  // namespace
+
+uint64_t telemetryNowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ==================== TelemetryPublisher类实现 ====================
+
+TelemetryPublisher::TelemetryPublisher() : segment(nullptr), lastPublishNs(0) {}
+
+TelemetryPublisher::~TelemetryPublisher() {
+    close();
+}
+
+/**
+ * @brief 创建共享内存段
+ * @details 同名的旧段（上次异常退出遗留）先删除；ftruncate得到的内存全为0，即所有序号和负载的初始值
+ */
+bool TelemetryPublisher::open(const std::string& segmentName) {
+    close();
+#ifndef _WIN32
+    shm_unlink(segmentName.c_str());
+    int fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, sizeof(TelemetrySegment)) != 0) {
+        ::close(fd);
+        shm_unlink(segmentName.c_str());
+        return false;
+    }
+    void* mapped = mmap(nullptr, sizeof(TelemetrySegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(segmentName.c_str());
+        return false;
+    }
+
+    segment = new (mapped) TelemetrySegment;
+    segment->magic = TelemetrySegment::MAGIC;
+    segment->version = TelemetrySegment::VERSION;
+    segment->snapshotBytes = sizeof(TelemetrySnapshot);
+    segment->eventCapacity = TelemetrySegment::EVENT_CAPACITY;
+    segment->publisherPid.store((uint64_t)getpid(), std::memory_order_release);
+    name = segmentName;
+    lastPublishNs = 0;
+    return true;
+#else
+    (void)segmentName;
+    return false;
+#endif
+}
+
+/**
+ * @brief 解除映射并删除段名
+ */
+void TelemetryPublisher::close() {
+#ifndef _WIN32
+    if (segment) {
+        segment->publisherPid.store(0, std::memory_order_release);
+        munmap(segment, sizeof(TelemetrySegment));
+        shm_unlink(name.c_str());
+    }
+#endif
+    segment = nullptr;
+    name.clear();
+}
+
+/**
+ * @brief 顺序锁写入
+ * @details 序号先变为奇数，release栅栏保证读者看到任何新负载时也能看到这个奇数；
+ *          负载写完后以release存储把序号变为下一个偶数
+ */
+void TelemetryPublisher::publish(TelemetrySnapshot snapshot) {
+    if (!segment) return;
+    uint64_t now = telemetryNowNs();
+    snapshot.timestampNs = now;
+    snapshot.frameTimeMs = lastPublishNs ? (float)((now - lastPublishNs) * 1e-6) : 0.0f;
+    lastPublishNs = now;
+
+    uint64_t sequence = segment->snapshotSequence.load(std::memory_order_relaxed);
+    segment->snapshotSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    storeWords(segment->snapshot, snapshot);
+    segment->snapshotSequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief 写入事件环
+ * @details 第head条事件写入槽位head%容量，写完后发布head+1。写槽位之前的release栅栏保证：
+ *          读者只要读到了新事件的任何一个字，之后读取的eventHead就至少是head，据此判定槽位已被覆盖
+ */
+void TelemetryPublisher::event(TelemetryEventType type, int32_t value, uint64_t frame) {
+    if (!segment) return;
+    TelemetryEvent e;
+    e.timestampNs = telemetryNowNs();
+    e.frame = frame;
+    e.type = (uint32_t)type;
+    e.value = value;
+
+    uint64_t head = segment->eventHead.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    storeWords(segment->events[head & (TelemetrySegment::EVENT_CAPACITY - 1)], e);
+    segment->eventHead.store(head + 1, std::memory_order_release);
+}
+
+// ==================== TelemetryReader类实现 ====================
+
+TelemetryReader::TelemetryReader() : segment(nullptr) {}
+
+TelemetryReader::~TelemetryReader() {
+    close();
+}
+
+bool TelemetryReader::open(const std::string& segmentName) {
+    close();
+#ifndef _WIN32
+    int fd = shm_open(segmentName.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    void* mapped = mmap(nullptr, sizeof(TelemetrySegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    const TelemetrySegment* candidate = static_cast<const TelemetrySegment*>(mapped);
+    if (candidate->magic != TelemetrySegment::MAGIC || candidate->version != TelemetrySegment::VERSION ||
+        candidate->snapshotBytes != sizeof(TelemetrySnapshot) ||
+        candidate->eventCapacity != TelemetrySegment::EVENT_CAPACITY) {
+        munmap(mapped, sizeof(TelemetrySegment));
+        return false;
+    }
+    segment = candidate;
+    return true;
+#else
+    (void)segmentName;
+    return false;
+#endif
+}
+
+void TelemetryReader::close() {
+#ifndef _WIN32
+    if (segment) {
+        munmap(const_cast<TelemetrySegment*>(segment), sizeof(TelemetrySegment));
+    }
+#endif
+    segment = nullptr;
+}
+
+bool TelemetryReader::readSnapshot(TelemetrySnapshot& out) const {
+    if (!segment) return false;
+    for (int attempt = 0; attempt < 1000; attempt++) {
+        uint64_t before = segment->snapshotSequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        TelemetrySnapshot copy;
+        loadWords(segment->snapshot, copy);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment->snapshotSequence.load(std::memory_order_relaxed) == before) {
+            out = copy;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t TelemetryReader::readEvents(uint64_t& cursor, TelemetryEvent* out, size_t maxEvents, uint64_t& dropped) const {
+    if (!segment) return 0;
+    const uint64_t capacity = TelemetrySegment::EVENT_CAPACITY;
+    uint64_t head = segment->eventHead.load(std::memory_order_acquire);
+    if (cursor > head) {
+        cursor = head;   // 序号来自另一个段（发布者重启过），从当前位置继续
+    }
+    if (head - cursor > capacity) {
+        dropped += head - capacity - cursor;
+        cursor = head - capacity;
+    }
+
+    size_t count = 0;
+    for (; cursor < head && count < maxEvents; cursor++) {
+        TelemetryEvent e;
+        loadWords(segment->events[cursor & (capacity - 1)], e);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // 发布者已经开始写第cursor+capacity条事件时，这个槽位可能被部分覆盖
+        if (segment->eventHead.load(std::memory_order_relaxed) >= cursor + capacity) {
+            dropped++;
+            continue;
+        }
+        out[count++] = e;
+    }
+    return count;
+}
+
+uint64_t TelemetryReader::eventHead() const {
+    return segment ? segment->eventHead.load(std::memory_order_acquire) : 0;
+}
+
+bool TelemetryReader::publisherAttached() const {
+    return segment && segment->publisherPid.load(std::memory_order_acquire) != 0;
+}
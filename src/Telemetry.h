@@ -0,0 +1,180 @@
+/**
+ * @file Telemetry.h
+ * @brief 共享内存遥测头文件
+ * @details 游戏每帧把状态快照写入POSIX共享内存段，按键、碰撞、重开等事件写入段内的环形缓冲区，
+ *          外部进程（dino_telemetry）只读映射同一个段进行监视。
+ *
+ *          快照由顺序锁保护：写入前后各把序号加1，读者看到奇数或前后序号不一致时重读；
+ *          事件环不加锁，读者按全局事件序号读取，复制后发现槽位可能已被覆盖就丢弃并计入丢失数。
+ *          写端从不等待读者，读者停顿或退出都不影响游戏
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct TelemetrySnapshot
+ * @brief 每帧发布的游戏状态
+ */
+struct TelemetrySnapshot {
+    uint64_t timestampNs = 0;       // 发布时间（steady_clock，同一台机器上各进程可比较）
+    uint64_t frame = 0;             // 发布序号（游戏循环的帧数，含结束画面）
+    uint32_t episode = 0;           // 局号
+    int32_t score = 0;              // 当前分数
+    int32_t highScore = 0;          // 最高分
+    int32_t gameSpeed = 0;          // 速度等级
+    int32_t obstaclesAlive = 0;     // 存活的障碍物数
+    float dinoY = 0;                // 恐龙y
+    float frameTimeMs = 0;          // 与上一次发布的间隔
+    uint8_t jumping = 0;
+    uint8_t ducking = 0;
+    uint8_t gameOver = 0;
+    uint8_t nightMode = 0;
+};
+
+/**
+ * @enum TelemetryEventType
+ * @brief 事件类型
+ */
+enum TelemetryEventType {
+    TELEMETRY_INPUT = 1,            // 按键（value为PlayerInput）
+    TELEMETRY_GAME_OVER = 2,        // 碰撞（value为分数）
+    TELEMETRY_RESTART = 3           // 开始新的一局（value为局号）
+};
+
+/**
+ * @struct TelemetryEvent
+ * @brief 事件环中的一条事件
+ */
+struct TelemetryEvent {
+    uint64_t timestampNs = 0;
+    uint64_t frame = 0;             // 首个反映该事件的快照的帧序号
+    uint32_t type = 0;              // TelemetryEventType
+    int32_t value = 0;
+};
+
+/**
+ * @struct TelemetrySegment
+ * @brief 共享内存段的布局
+ * @details 负载以relaxed原子字存放，读写两端逐字复制，顺序锁和事件序号负责一致性；
+ *          magic、version和两个尺寸字段供读者拒绝不兼容的段
+ */
+struct TelemetrySegment {
+    static const uint32_t MAGIC = 0x444e5454;       // "TTND"
+    static const uint32_t VERSION = 1;
+    static const size_t EVENT_CAPACITY = 1024;      // 事件环容量（2的幂）
+    static const size_t SNAPSHOT_WORDS = (sizeof(TelemetrySnapshot) + 7) / 8;
+    static const size_t EVENT_WORDS = (sizeof(TelemetryEvent) + 7) / 8;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t snapshotBytes;
+    uint32_t eventCapacity;
+    std::atomic<uint64_t> publisherPid;                 // 发布者进程号，关闭时清零
+    alignas(64) std::atomic<uint64_t> snapshotSequence; // 顺序锁：奇数表示正在写
+    std::atomic<uint64_t> snapshot[SNAPSHOT_WORDS];
+    alignas(64) std::atomic<uint64_t> eventHead;        // 已写入的事件总数
+    std::atomic<uint64_t> events[EVENT_CAPACITY][EVENT_WORDS];
+};
+
+/**
+ * @brief 默认的共享内存段名称
+ */
+extern const char* const TELEMETRY_DEFAULT_NAME;
+
+/**
+ * @class TelemetryPublisher
+ * @brief 遥测发布端（游戏进程）
+ * @details 创建并独占共享内存段，关闭时删除段名（已映射的读者仍可读到最后的内容）。
+ *          publish和event只做十来个字的relaxed存储和一次release栅栏，不分配内存、不加锁、不进行系统调用。
+ *          只支持单个写线程；不支持POSIX共享内存的平台上open返回false
+ */
+class TelemetryPublisher {
+private:
+    TelemetrySegment* segment;
+    std::string name;
+    uint64_t lastPublishNs;
+
+public:
+    TelemetryPublisher();
+    ~TelemetryPublisher();
+
+    TelemetryPublisher(const TelemetryPublisher&) = delete;
+    TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+    /**
+     * @param name 共享内存段名称（以'/'开头）
+     */
+    bool open(const std::string& name = TELEMETRY_DEFAULT_NAME);
+    void close();
+    bool isOpen() const { return segment != nullptr; }
+
+    /**
+     * @brief 发布一帧快照（timestampNs和frameTimeMs由发布端填写）
+     */
+    void publish(TelemetrySnapshot snapshot);
+
+    /**
+     * @brief 追加一条事件，环满时覆盖最旧的事件
+     */
+    void event(TelemetryEventType type, int32_t value, uint64_t frame);
+};
+
+/**
+ * @class TelemetryReader
+ * @brief 遥测读取端（监视进程），只读映射共享内存段
+ */
+class TelemetryReader {
+private:
+    const TelemetrySegment* segment;
+
+public:
+    TelemetryReader();
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    /**
+     * @brief 映射已存在的段并检查版本和布局
+     */
+    bool open(const std::string& name = TELEMETRY_DEFAULT_NAME);
+    void close();
+    bool isOpen() const { return segment != nullptr; }
+
+    /**
+     * @brief 读取一致的快照
+     * @return 重试次数用完仍未读到一致的快照时返回false（发布者在两次重试之间总在写，实际极少发生）
+     */
+    bool readSnapshot(TelemetrySnapshot& out) const;
+
+    /**
+     * @brief 从cursor（事件序号）开始读取新事件
+     * @param cursor 输入下一条要读的序号，输出读完后的序号
+     * @param dropped 累加因读得太慢被覆盖而丢失的事件数
+     * @return 写入out的事件数
+     */
+    size_t readEvents(uint64_t& cursor, TelemetryEvent* out, size_t maxEvents, uint64_t& dropped) const;
+
+    /**
+     * @brief 已写入的事件总数（新读者可以从这里开始，只看之后的事件）
+     */
+    uint64_t eventHead() const;
+
+    /**
+     * @brief 发布者是否仍持有该段（未正常关闭）
+     */
+    bool publisherAttached() const;
+};
+
+/**
+ * @brief steady_clock当前时间（纳秒）
+ */
+uint64_t telemetryNowNs();
+
+#endif // TELEMETRY_H
@@ -0,0 +1,129 @@
+/**
+ * @file TelemetryMain.cpp
+ * @brief 遥测监视工具
+ * @details 只读映射游戏的遥测共享内存段，按固定间隔输出一行状态和期间的新事件；
+ *          游戏退出或重启后自动重新连接
+ *
+ * 用法：dino_telemetry [--name 段名] [--interval 毫秒] [--count 行数]
+ *   --count 0（默认）表示一直运行
+ */
+
+#include "OptimizedDinoGame.h"
+#include "Telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+const char* inputName(int input) {
+    switch (input) {
+    case INPUT_JUMP_KEY: return "jump";
+    case INPUT_DUCK_KEY: return "duck";
+    default: return "none";
+    }
+}
+
+void printEvent(const TelemetryEvent& e) {
+    std::cout << "  [frame " << e.frame << "] ";
+    switch (e.type) {
+    case TELEMETRY_INPUT:     std::cout << "input " << inputName(e.value); break;
+    case TELEMETRY_GAME_OVER: std::cout << "game over, score " << e.value; break;
+    case TELEMETRY_RESTART:   std::cout << "episode " << e.value << " started"; break;
+    default:                  std::cout << "unknown event " << e.type; break;
+    }
+    std::cout << '\n';
+}
+
+}  // namespace
+
+/**
+ * @brief 监视工具主入口
+ * @return 参数错误返回1，否则返回0
+ */
+int main(int argc, char** argv) {
+    std::string name = TELEMETRY_DEFAULT_NAME;
+    int intervalMs = 500;
+    long long count = 0;
+
+    for (int i = 1; i < argc; i += 2) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::cerr << "missing value for " << argv[i] << std::endl;
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--name") == 0) {
+            name = value;
+        } else if (std::strcmp(argv[i], "--interval") == 0) {
+            intervalMs = std::max(1, std::atoi(value));
+        } else if (std::strcmp(argv[i], "--count") == 0) {
+            count = std::atoll(value);
+        } else {
+            std::cerr << "unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    TelemetryReader reader;
+    TelemetryEvent events[64];
+    uint64_t cursor = 0;
+    uint64_t dropped = 0;
+    uint64_t lastFrame = 0;
+    auto lastRead = std::chrono::steady_clock::now();
+
+    for (long long line = 0; count <= 0 || line < count; line++) {
+        if (line > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        }
+
+        // 发布者关闭后段名被删除，新的游戏进程会创建新的段
+        if (!reader.publisherAttached()) {
+            reader.close();
+            if (!reader.open(name)) {
+                std::cout << "waiting for " << name << std::endl;
+                continue;
+            }
+            cursor = reader.eventHead();   // 只显示连接之后的事件
+            lastFrame = 0;
+        }
+
+        TelemetrySnapshot s;
+        if (!reader.readSnapshot(s)) {
+            std::cout << "snapshot busy" << std::endl;
+            continue;
+        }
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - lastRead).count();
+        double fps = (lastFrame > 0 && s.frame >= lastFrame && seconds > 0) ? (s.frame - lastFrame) / seconds : 0;
+        double ageMs = (telemetryNowNs() - s.timestampNs) * 1e-6;
+        lastRead = now;
+        lastFrame = s.frame;
+
+        std::cout << "frame " << s.frame << " episode " << s.episode << " score " << s.score << " (best "
+                  << s.highScore << ") speed " << s.gameSpeed << " obstacles " << s.obstaclesAlive << " y "
+                  << s.dinoY << (s.jumping ? " jumping" : "") << (s.ducking ? " ducking" : "") << " | frame "
+                  << s.frameTimeMs << " ms, " << fps << " fps" << (s.gameOver ? " | GAME OVER" : "")
+                  << (s.nightMode ? " | night" : "");
+        if (ageMs > 1000) {
+            std::cout << " | stalled " << ageMs / 1000 << " s";
+        }
+        std::cout << '\n';
+
+        size_t n;
+        while ((n = reader.readEvents(cursor, events, 64, dropped)) > 0) {
+            for (size_t i = 0; i < n; i++) {
+                printEvent(events[i]);
+            }
+        }
+        if (dropped > 0) {
+            std::cout << "  (" << dropped << " events dropped)\n";
+            dropped = 0;
+        }
+        std::cout << std::flush;
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file TrainerMain.cpp
+ * @brief 神经进化训练器主程序
+ * @details 解析命令行参数，创建NeuroTrainer并运行训练
+ *
+ * 用法：dino_trainer [--population N] [--generations N] [--frames N] [--courses N]
+ *                    [--threads N] [--elite N] [--seed N] [--checkpoint 文件]
+ *                    [--resume 文件] [--curve 文件.csv]
+ */
+
+#include "DinoTrainer.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief 训练器主入口
+ * @return 参数错误或读档失败返回1，否则返回0
+ */
+int main(int argc, char** argv) {
+    TrainerConfig config;
+    std::string resumePath;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::cerr << "missing value for " << arg << std::endl;
+            return 1;
+        }
+        if (std::strcmp(arg, "--population") == 0) {
+            config.populationSize = std::atoi(value);
+        } else if (std::strcmp(arg, "--generations") == 0) {
+            config.generations = std::atoi(value);
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            config.maxFrames = std::atoi(value);
+        } else if (std::strcmp(arg, "--courses") == 0) {
+            config.coursesPerGeneration = std::atoi(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            config.threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--elite") == 0) {
+            config.eliteCount = std::atoi(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            config.seed = (uint32_t)std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--checkpoint") == 0) {
+            config.checkpointPath = value;
+        } else if (std::strcmp(arg, "--resume") == 0) {
+            resumePath = value;
+        } else if (std::strcmp(arg, "--curve") == 0) {
+            config.curvePath = value;
+        } else {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return 1;
+        }
+        i++;
+    }
+
+    NeuroTrainer trainer(config);
+    if (!resumePath.empty() && !trainer.loadCheckpoint(resumePath)) {
+        return 1;
+    }
+
+    trainer.run();
+    return 0;
+}
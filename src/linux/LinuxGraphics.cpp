@@ -0,0 +1,514 @@
+/**
+ * @file LinuxGraphics.cpp
+ * @brief Linux下EGE/conio兼容层实现文件
+ * @details 帧缓冲绘制、5×7点阵文字、ANSI终端呈现和键盘输入
+ *
+ * 呈现方式：
+ *   - 帧缓冲按终端大小分块求平均颜色，每个字符格用“▀”表示上下两个像素块
+ *   - 只输出与上一帧不同的字符格，颜色未变化时不重复输出颜色转义序列
+ *   - 连续多个上下同色的变化字符格（如昼夜渐变时的整片天空）以背景色擦除字符（ECH）一次填充
+ *   - 一帧的全部输出拼接在同一个预留好的缓冲区中，只调用一次write
+ */
+
+#include "graphics.h"
+#include "conio.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+// ==================== 5×7点阵字体 ====================
+
+/**
+ * @struct Glyph
+ * @brief 一个字符的点阵，每行低5位有效，最高位在左
+ */
+struct Glyph {
+    char ch;
+    unsigned char rows[7];
+};
+
+const Glyph FONT[] = {
+    {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+    {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+    {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+    {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+    {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+    {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+    {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+    {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+    {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+    {'A', {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}},
+    {'B', {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}},
+    {'C', {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},
+    {'D', {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}},
+    {'E', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},
+    {'F', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}},
+    {'G', {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}},
+    {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+    {'I', {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'J', {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}},
+    {'K', {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}},
+    {'L', {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}},
+    {'M', {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},
+    {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},
+    {'O', {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'P', {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}},
+    {'Q', {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}},
+    {'R', {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},
+    {'S', {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}},
+    {'T', {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+    {'U', {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'V', {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},
+    {'W', {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}},
+    {'X', {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}},
+    {'Y', {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}},
+    {'Z', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}},
+    {'!', {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}},
+    {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+    {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+    {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+};
+
+const Glyph* findGlyph(char ch) {
+    if (ch >= 'a' && ch <= 'z') {
+        ch = (char)(ch - 'a' + 'A');  // 小写字母使用大写点阵
+    }
+    for (const Glyph& glyph : FONT) {
+        if (glyph.ch == ch) return &glyph;
+    }
+    return nullptr;  // 空格及未收录字符只占位不绘制
+}
+
+// ==================== 帧缓冲与绘图状态 ====================
+
+/**
+ * @struct Canvas
+ * @brief 全局绘图状态（对应EGE的默认窗口）
+ */
+struct Canvas {
+    int width = 0, height = 0;
+    std::vector<ege::color_t> pixels;     // 帧缓冲，pixels[y * width + x]
+    ege::color_t bkColor = ege::BLACK;
+    ege::color_t fillColor = ege::WHITE;
+    ege::color_t textColor = ege::WHITE;
+    int bkMode = ege::OPAQUE;
+    int fontScale = 2;                    // 点阵放大倍数，由setfont的高度决定
+    bool open = false;
+};
+
+/**
+ * @struct Terminal
+ * @brief 终端呈现状态
+ */
+struct Terminal {
+    termios savedMode;
+    bool modeSaved = false;
+    int cols = 0, rows = 0;               // 使用的字符格数
+    int block = 1;                        // 每个像素块对应的帧缓冲边长
+    std::vector<ege::color_t> cells;      // 上一帧每个字符格的上/下颜色（交替存放）
+    std::vector<ege::color_t> next;       // 本帧的字符格颜色
+    std::string out;                      // 输出缓冲区（预留容量，逐帧复用）
+};
+
+/**
+ * @struct Stats
+ * @brief 呈现计时
+ * @details 延迟按0.05毫秒一档计入固定的直方图（最后一档收容50毫秒以上），
+ *          与累计值和最大值一起在任意长的运行中占用固定内存，呈现时不分配
+ */
+struct Stats {
+    static const int LATENCY_BUCKETS = 1001;
+    static constexpr double BUCKET_MS = 0.05;
+
+    long long frames = 0;
+    double sumMs = 0;
+    double maxMs = 0;
+    long long histogram[LATENCY_BUCKETS] = {};
+    long long bytes = 0;
+    std::chrono::steady_clock::time_point first, last;
+};
+
+Canvas canvas;
+Terminal term;
+Stats stats;
+
+inline void fillSpan(int y, int x0, int x1, ege::color_t color) {
+    if (y < 0 || y >= canvas.height) return;
+    x0 = std::max(0, x0);
+    x1 = std::min(canvas.width, x1);
+    if (x0 >= x1) return;
+    std::fill(canvas.pixels.begin() + (size_t)y * canvas.width + x0,
+              canvas.pixels.begin() + (size_t)y * canvas.width + x1, color);
+}
+
+void restoreTerminal() {
+    if (!term.modeSaved) return;
+    const char* leave = "\033[0m\033[?25h\033[?1049l";
+    ssize_t written = write(STDOUT_FILENO, leave, std::strlen(leave));
+    (void)written;
+    tcsetattr(STDIN_FILENO, TCSANOW, &term.savedMode);
+    term.modeSaved = false;
+}
+
+/**
+ * @brief 根据终端大小确定字符格数和缩放块大小
+ * @details 每个字符格上下各一个正方形像素块，块边长取能完整放下画面的最小整数
+ */
+void layoutTerminal() {
+    winsize size;
+    int cols = 160, rows = 50;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 1) {
+        cols = size.ws_col;
+        rows = size.ws_row - 1;
+    }
+    int block = std::max((canvas.width + cols - 1) / cols, (canvas.height + rows * 2 - 1) / (rows * 2));
+    term.block = std::max(1, block);
+    term.cols = (canvas.width + term.block - 1) / term.block;
+    term.rows = (canvas.height + term.block * 2 - 1) / (term.block * 2);
+    term.cells.assign((size_t)term.cols * term.rows * 2, 0xFFFFFFFFu);  // 不可能的颜色，保证首帧全部输出
+    term.next.assign(term.cells.size(), 0);
+    term.out.reserve((size_t)term.cols * term.rows * 48);
+}
+
+void appendInt(std::string& out, int value) {
+    char digits[12];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (n > 0) out.push_back(digits[--n]);
+}
+
+void appendColor(std::string& out, int code, ege::color_t color) {
+    out.push_back(';');
+    appendInt(out, code);
+    out.append(";2;");
+    appendInt(out, (color >> 16) & 0xFF);
+    out.push_back(';');
+    appendInt(out, (color >> 8) & 0xFF);
+    out.push_back(';');
+    appendInt(out, color & 0xFF);
+}
+
+/**
+ * @brief 求帧缓冲中一个像素块的平均颜色
+ */
+ege::color_t averageBlock(int bx, int by) {
+    int x0 = bx * term.block, y0 = by * term.block;
+    int x1 = std::min(canvas.width, x0 + term.block), y1 = std::min(canvas.height, y0 + term.block);
+    if (x0 >= x1 || y0 >= y1) return canvas.bkColor;
+
+    unsigned r = 0, g = 0, b = 0, n = 0;
+    for (int y = y0; y < y1; y++) {
+        const ege::color_t* row = &canvas.pixels[(size_t)y * canvas.width];
+        for (int x = x0; x < x1; x++) {
+            r += (row[x] >> 16) & 0xFF;
+            g += (row[x] >> 8) & 0xFF;
+            b += row[x] & 0xFF;
+            n++;
+        }
+    }
+    return ((r / n) << 16) | ((g / n) << 8) | (b / n);
+}
+
+/**
+ * @brief 把帧缓冲呈现到终端
+ * @return 本帧写入的字节数
+ */
+size_t present() {
+    const int MIN_ERASE_RUN = 8;    // 短于此长度时逐格输出半块字符更省字节
+    for (int row = 0; row < term.rows; row++) {
+        for (int col = 0; col < term.cols; col++) {
+            size_t cell = ((size_t)row * term.cols + col) * 2;
+            term.next[cell] = averageBlock(col, row * 2);
+            term.next[cell + 1] = averageBlock(col, row * 2 + 1);
+        }
+    }
+
+    std::string& out = term.out;
+    out.clear();
+    ege::color_t fg = 0xFFFFFFFFu, bg = 0xFFFFFFFFu;
+    int cursorRow = -1, cursorCol = -1;
+    for (int row = 0; row < term.rows; row++) {
+        for (int col = 0; col < term.cols; col++) {
+            size_t cell = ((size_t)row * term.cols + col) * 2;
+            ege::color_t top = term.next[cell], bottom = term.next[cell + 1];
+            if (top == term.cells[cell] && bottom == term.cells[cell + 1]) continue;
+
+            // 同色且都有变化的一段字符格：设置背景色后用ECH擦除，光标不移动
+            int run = 0;
+            if (top == bottom) {
+                size_t c = cell;
+                while (col + run < term.cols && term.next[c] == top && term.next[c + 1] == top &&
+                       (term.cells[c] != top || term.cells[c + 1] != top)) {
+                    run++;
+                    c += 2;
+                }
+            }
+            if (run >= MIN_ERASE_RUN) {
+                for (int i = 0; i < run; i++) {
+                    term.cells[cell + i * 2] = top;
+                    term.cells[cell + i * 2 + 1] = top;
+                }
+                if (row != cursorRow || col != cursorCol) {
+                    out.append("\033[");
+                    appendInt(out, row + 1);
+                    out.push_back(';');
+                    appendInt(out, col + 1);
+                    out.push_back('H');
+                }
+                if (top != bg) {
+                    out.append("\033[0");
+                    appendColor(out, 48, top);
+                    out.push_back('m');
+                    fg = 0xFFFFFFFFu;   // 属性已重置，下一个半块字符需要重新设置前景色
+                    bg = top;
+                }
+                out.append("\033[");
+                appendInt(out, run);
+                out.push_back('X');
+                cursorRow = row;
+                cursorCol = col;
+                col += run - 1;
+                continue;
+            }
+            term.cells[cell] = top;
+            term.cells[cell + 1] = bottom;
+
+            if (row != cursorRow || col != cursorCol) {
+                out.append("\033[");
+                appendInt(out, row + 1);
+                out.push_back(';');
+                appendInt(out, col + 1);
+                out.push_back('H');
+            }
+            if (top != fg || bottom != bg) {
+                out.append("\033[0");
+                if (top != fg) appendColor(out, 38, top);
+                if (bottom != bg) appendColor(out, 48, bottom);
+                out.push_back('m');
+                fg = top;
+                bg = bottom;
+            }
+            out.append("\xE2\x96\x80");  // ▀：前景色为上半块，背景色为下半块
+            cursorRow = row;
+            cursorCol = col + 1;
+        }
+    }
+
+    size_t done = 0;
+    while (done < out.size()) {
+        ssize_t n = write(STDOUT_FILENO, out.data() + done, out.size() - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    return out.size();
+}
+
+}  // namespace
+
+namespace ege {
+
+void initgraph(int width, int height) {
+    canvas.width = width;
+    canvas.height = height;
+    canvas.pixels.assign((size_t)width * height, canvas.bkColor);
+    canvas.open = true;
+
+    if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &term.savedMode) == 0) {
+        termios raw = term.savedMode;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+        term.modeSaved = true;
+        std::atexit(restoreTerminal);
+    }
+    const char* enter = "\033[?1049h\033[?25l\033[2J";
+    ssize_t written = write(STDOUT_FILENO, enter, std::strlen(enter));
+    (void)written;
+
+    layoutTerminal();
+}
+
+void closegraph() {
+    if (!canvas.open) return;
+    canvas.open = false;
+    restoreTerminal();
+
+    PresentStats s = getPresentStats();
+    if (s.frames > 0) {
+        std::fprintf(stderr,
+            "present: %lld frames, %.1f fps, latency mean %.3f ms / p99 %.3f ms / max %.3f ms, %.0f bytes/frame\n",
+            s.frames, s.fps, s.meanLatencyMs, s.p99LatencyMs, s.maxLatencyMs, s.bytesPerFrame);
+    }
+}
+
+void setcaption(const char* caption) {
+    std::string title = std::string("\033]0;") + caption + "\007";
+    ssize_t written = write(STDOUT_FILENO, title.data(), title.size());
+    (void)written;
+}
+
+void setrendermode(rendermode_e) {}
+
+/**
+ * @brief 设置背景色
+ * @details 与EGE相同，画面上原背景色的像素会被替换为新背景色
+ */
+void setbkcolor(color_t color) {
+    if (color == canvas.bkColor) return;
+    std::replace(canvas.pixels.begin(), canvas.pixels.end(), canvas.bkColor, color);
+    canvas.bkColor = color;
+}
+
+void setbkcolor_f(color_t color) {
+    canvas.bkColor = color;
+}
+
+void cleardevice() {
+    std::fill(canvas.pixels.begin(), canvas.pixels.end(), canvas.bkColor);
+}
+
+void setfillcolor(color_t color) { canvas.fillColor = color; }
+void setcolor(color_t color) { canvas.textColor = color; }
+void setbkmode(int mode) { canvas.bkMode = mode; }
+
+void solidrect(int left, int top, int right, int bottom) {
+    for (int y = std::max(0, top); y < std::min(canvas.height, bottom); y++) {
+        fillSpan(y, left, right, canvas.fillColor);
+    }
+}
+
+void solidellipse(int left, int top, int right, int bottom) {
+    float cx = (left + right) / 2.0f, cy = (top + bottom) / 2.0f;
+    float rx = (right - left) / 2.0f, ry = (bottom - top) / 2.0f;
+    if (rx <= 0 || ry <= 0) return;
+    for (int y = top; y < bottom; y++) {
+        float dy = (y + 0.5f - cy) / ry;
+        if (dy * dy > 1) continue;
+        float half = rx * std::sqrt(1 - dy * dy);
+        fillSpan(y, (int)std::lround(cx - half), (int)std::lround(cx + half), canvas.fillColor);
+    }
+}
+
+void setfont(int height, int, const char*) {
+    canvas.fontScale = std::max(1, height / 8);
+}
+
+int textwidth(const char* text) {
+    return (int)std::strlen(text) * 6 * canvas.fontScale;
+}
+
+void outtextxy(int x, int y, const char* text) {
+    int scale = canvas.fontScale;
+    if (canvas.bkMode == OPAQUE) {
+        for (int row = 0; row < 8 * scale; row++) {
+            fillSpan(y + row, x, x + textwidth(text), canvas.bkColor);
+        }
+    }
+    for (const char* p = text; *p; p++, x += 6 * scale) {
+        const Glyph* glyph = findGlyph(*p);
+        if (!glyph) continue;
+        for (int row = 0; row < 7; row++) {
+            for (int bit = 0; bit < 5; bit++) {
+                if (!(glyph->rows[row] & (0x10 >> bit))) continue;
+                for (int dy = 0; dy < scale; dy++) {
+                    fillSpan(y + row * scale + dy, x + bit * scale, x + (bit + 1) * scale, canvas.textColor);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 呈现当前帧并休眠
+ * @details 呈现延迟只统计缩放、比较和写终端的耗时，不包括随后的休眠
+ */
+void delay_ms(long ms) {
+    if (canvas.open) {
+        auto start = std::chrono::steady_clock::now();
+        size_t bytes = present();
+        auto end = std::chrono::steady_clock::now();
+
+        double latencyMs = std::chrono::duration<double, std::milli>(end - start).count();
+        if (stats.frames == 0) stats.first = start;
+        stats.last = end;
+        stats.frames++;
+        stats.sumMs += latencyMs;
+        stats.maxMs = std::max(stats.maxMs, latencyMs);
+        stats.histogram[std::min(Stats::LATENCY_BUCKETS - 1, (int)(latencyMs / Stats::BUCKET_MS))]++;
+        stats.bytes += (long long)bytes;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/**
+ * @details p99取直方图中累计达到99%的那一档的上沿（不超过最大值）
+ */
+PresentStats getPresentStats() {
+    PresentStats s = {};
+    s.frames = stats.frames;
+    if (s.frames == 0) return s;
+
+    double seconds = std::chrono::duration<double>(stats.last - stats.first).count();
+    long long rank = (long long)(s.frames * 0.99);
+    long long seen = 0;
+    int bucket = 0;
+    while (bucket < Stats::LATENCY_BUCKETS - 1 && (seen += stats.histogram[bucket]) <= rank) {
+        bucket++;
+    }
+
+    s.fps = seconds > 0 ? (s.frames - 1) / seconds : 0;
+    s.meanLatencyMs = stats.sumMs / s.frames;
+    s.p99LatencyMs = std::min(stats.maxMs, (bucket + 1) * Stats::BUCKET_MS);
+    s.maxLatencyMs = stats.maxMs;
+    s.bytesPerFrame = (double)stats.bytes / s.frames;
+    return s;
+}
+
+}  // namespace ege
+
+// ==================== conio兼容 ====================
+
+int kbhit() {
+    pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    return poll(&fd, 1, 0) > 0 && (fd.revents & POLLIN);
+}
+
+/**
+ * @brief 读取一个按键
+ * @details ESC之后若紧跟"[A/B/C/D"则视为方向键，返回conio扫描码；单独的ESC返回27
+ */
+int getch() {
+    unsigned char ch = 0;
+    if (read(STDIN_FILENO, &ch, 1) != 1) return -1;
+    if (ch != 27 || !kbhit()) return ch;
+
+    unsigned char seq[2];
+    if (read(STDIN_FILENO, &seq[0], 1) != 1 || seq[0] != '[' || !kbhit() ||
+        read(STDIN_FILENO, &seq[1], 1) != 1) {
+        return 27;
+    }
+    switch (seq[1]) {
+    case 'A': return 72;
+    case 'B': return 80;
+    case 'C': return 77;
+    case 'D': return 75;
+    default: return 27;
+    }
+}
@@ -0,0 +1,20 @@
+/**
+ * @file conio.h
+ * @brief Linux下conio键盘接口的兼容实现（头文件）
+ * @details 终端处于非规范模式，方向键的转义序列被转换为conio的扫描码（上72、下80、左75、右77）
+ */
+
+#ifndef DINO_LINUX_CONIO_H
+#define DINO_LINUX_CONIO_H
+
+/**
+ * @brief 是否有未读取的按键
+ */
+int kbhit();
+
+/**
+ * @brief 读取一个按键（没有按键时阻塞）
+ */
+int getch();
+
+#endif // DINO_LINUX_CONIO_H
@@ -0,0 +1,83 @@
+/**
+ * @file ege.h
+ * @brief Linux下EGE图形接口的兼容实现（头文件）
+ * @details 只实现游戏用到的EGE子集：窗口、填充矩形/椭圆、文字、背景色和手动渲染。
+ *          所有绘制都写入CPU帧缓冲，delay_ms时把帧缓冲以ANSI真彩色半块字符输出到终端
+ */
+
+#ifndef DINO_LINUX_EGE_H
+#define DINO_LINUX_EGE_H
+
+#include <cstdint>
+
+namespace ege {
+
+typedef uint32_t color_t;   // 0xRRGGBB
+
+enum rendermode_e {
+    RENDER_AUTO,
+    RENDER_MANUAL
+};
+
+enum bkmode_e {
+    TRANSPARENT = 1,
+    OPAQUE = 2
+};
+
+const color_t BLACK = 0x000000;
+const color_t WHITE = 0xFFFFFF;
+const color_t RED = 0xFF0000;
+
+/**
+ * @brief 创建帧缓冲并切换终端到全屏字符画模式
+ */
+void initgraph(int width, int height);
+
+/**
+ * @brief 恢复终端并输出呈现统计（帧率、呈现延迟、每帧字节数）
+ */
+void closegraph();
+
+void setcaption(const char* caption);
+void setrendermode(rendermode_e mode);
+
+void setbkcolor(color_t color);         // 与EGE相同，画布上旧背景色的像素替换为新背景色
+void setbkcolor_f(color_t color);       // 只设置背景色，不改动已有像素（随后cleardevice时使用）
+void cleardevice();
+void setfillcolor(color_t color);
+void setcolor(color_t color);
+void setbkmode(int mode);
+
+void solidrect(int left, int top, int right, int bottom);
+void solidellipse(int left, int top, int right, int bottom);
+
+void setfont(int height, int width, const char* face);
+void outtextxy(int x, int y, const char* text);
+int textwidth(const char* text);
+
+/**
+ * @brief 呈现当前帧并休眠
+ * @details 与EGE手动渲染模式一致：调用时才把帧缓冲刷新到屏幕
+ */
+void delay_ms(long ms);
+
+/**
+ * @struct PresentStats
+ * @brief 终端呈现统计
+ */
+struct PresentStats {
+    long long frames;           // 已呈现帧数
+    double fps;                 // 平均帧率
+    double meanLatencyMs;       // 平均呈现延迟（缩放、比较、写终端）
+    double p99LatencyMs;        // 99分位呈现延迟（精确到0.05毫秒）
+    double maxLatencyMs;        // 最大呈现延迟
+    double bytesPerFrame;       // 平均每帧写入终端的字节数
+};
+
+PresentStats getPresentStats();
+
+}  // namespace ege
+
+#define RGB(r, g, b) ((ege::color_t)(((r) << 16) | ((g) << 8) | (b)))
+
+#endif // DINO_LINUX_EGE_H
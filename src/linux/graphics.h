@@ -0,0 +1,14 @@
+/**
+ * @file graphics.h
+ * @brief Linux下EGE兼容层入口头文件
+ * @details 与EGE的graphics.h一样引入ege命名空间
+ */
+
+#ifndef DINO_LINUX_GRAPHICS_H
+#define DINO_LINUX_GRAPHICS_H
+
+#include "ege.h"
+
+using namespace ege;
+
+#endif // DINO_LINUX_GRAPHICS_H